@@ -17,16 +17,27 @@
 // ------- SIMULATION TEST ------------ -------
 #define FLIP_SIM_AUTOTEST 1
 
+#ifdef HOST_SIM
+#define FLIP_LOG(...) SIM_LOG(__VA_ARGS__)
+#else
+#define FLIP_LOG(...) ((void)0)
+#endif
+
 #ifdef HOST_SIM
     static void integrate_pose_from_pwm();
 #endif
 
+// Host sim: one copy per thread (mock_all.h); on target this expands to nothing.
+#ifndef SIM_THREAD_LOCAL
+#define SIM_THREAD_LOCAL
+#endif
+
 static FlipController* gFlip = nullptr;
 
 // Local task handle since the header no longer exposes one
-static TaskHandle_t sFlipTaskHandle = nullptr;
+static SIM_THREAD_LOCAL TaskHandle_t sFlipTaskHandle = nullptr;
 // Local yaw sign used during side flips
-static int8_t sYawSign = 0;
+static SIM_THREAD_LOCAL int8_t sYawSign = 0;
 
 void flip_bind(RSBL8512& yaw, RSBL8512& pitch) {
     static FlipController controller(yaw, pitch);
@@ -40,50 +51,15 @@ void flip_command() {
     }
 }
 
-static inline float normalize_deg(float a) {
-    while (a <= -180.0f) a += 360.0f;
-    while (a > 180.0f) a -= 360.0f;
-    return a;
-}
-
-static inline float shortest_delta_deg(float from, float to) {
-    float diff = to - from;
-    while (diff < -180.0f) diff += 360.0f;
-    while (diff > 180.0f) diff -= 360.0f;
-    return diff;
-}
-
-static inline float step_towards(float current, float target, float max_step) {
-    float d = shortest_delta_deg(current, target);
-    if (d >  max_step) return normalize_deg(current + max_step);
-    if (d < -max_step) return normalize_deg(current - max_step);
-    return normalize_deg(target);
-}
-
-static inline int8_t clamp_i8(int v, int lo, int hi) {
-    if (v < lo) return (int8_t)lo;
-    if (v > hi) return (int8_t)hi;
-    return (int8_t)v;
-}
-
-static inline int8_t p_cmd(float err_deg, float kp, int8_t max_pwm, float deadband_deg) {
-    if (fabsf(err_deg) <= deadband_deg) return 0;
-    float u = kp * err_deg;
-    return clamp_i8((int)lroundf(u), -max_pwm, max_pwm);
-}
-
-static motors_action_t last_motor_cmd{};
-
-static void send_yaw_pitch_cmd(int8_t yaw_pwm, int8_t pitch_pwm) {
+// drive_pwm != 0 marks a flip-assist pulse on the drive train.
+static void send_motor_cmd(int8_t yaw_pwm, int8_t pitch_pwm, int8_t drive_pwm) {
     motors_action_t act{};
-    act.drive = 0;
+    act.drive = drive_pwm;
     act.yaw = yaw_pwm;
     act.pitch = pitch_pwm;
     act.auto_neutral_joints = 0;
-    act.drive_pulse = 0;
-    act.flip_mode = 0;
-
-    last_motor_cmd = act; // store for simulation use
+    act.drive_pulse = drive_pwm ? 1 : 0;
+    act.flip_mode = drive_pwm ? 1 : 0;
     set_motors(&act);
 }
 
@@ -97,41 +73,88 @@ static constexpr float SCORPION_DEG    = 75.0f;
 static constexpr float YAW_RATE_DPS    = 90.0f;
 static constexpr float PITCH_RATE_DPS  = 120.0f;
 
-static constexpr float KP_YAW          = 1.6f;
-static constexpr float KP_PITCH        = 1.6f;
-static constexpr int8_t MAX_PWM_YAW    = 100;
-static constexpr int8_t MAX_PWM_PITCH  = 60;
-
 static constexpr float YAW_EPS_DEG     = 1.0f;
 static constexpr float PITCH_EPS_DEG   = 1.0f;
 
 static constexpr float DT_SEC          = 0.010f;
+static constexpr int32_t DT_MS         = 10;
+
+static constexpr flipmath::angle_t PITCH_STEP_MAX = flipmath::deg(PITCH_RATE_DPS * DT_SEC);
+
+// The params task only waits on flash; how often it checks for a pending save.
+// It runs for the controller's lifetime, enabled or not.
+static constexpr uint32_t PARAM_POLL_MS = 500;
+
+static constexpr flipmath::angle_t YAW_EPS   = flipmath::deg(YAW_EPS_DEG);
+static constexpr flipmath::angle_t PITCH_EPS = flipmath::deg(PITCH_EPS_DEG);
+
+// P gains [PWM/deg], converted here so the loop never touches a float.
+static constexpr flipmath::gain_t KP_YAW   = flipmath::gain(1.0f);
+static constexpr flipmath::gain_t KP_PITCH = flipmath::gain(1.0f);
+
+// Orientation thresholds and targets.
+static constexpr flipmath::angle_t PITCH_LEVEL       = flipmath::deg(0.0f);
+static constexpr flipmath::angle_t PITCH_RIGHT_SIDE  = flipmath::deg(90.0f);
+static constexpr flipmath::angle_t PITCH_LEFT_SIDE   = flipmath::deg(-90.0f);
+static constexpr flipmath::angle_t PITCH_UPSIDE_TH   = flipmath::deg(90.0f);
+static constexpr flipmath::angle_t PITCH_RIGHT_TH    = flipmath::deg(45.0f);
+static constexpr flipmath::angle_t PITCH_LEFT_TH     = flipmath::deg(-45.0f);
+static constexpr flipmath::angle_t YAW_QUARTER_LEFT  = flipmath::deg(90.0f);
+static constexpr flipmath::angle_t YAW_QUARTER_RIGHT = flipmath::deg(-90.0f);
+
+// Drive-train assist during PITCH_DOWN: a timed pulse is fired whenever the
+// measured pitch rate falls below DRIVE_LAG_NUM/DRIVE_LAG_DEN of the
+// trajectory step, and never inside DRIVE_MIN_ERR_DEG of the target.
+static constexpr int8_t DRIVE_ASSIST_PWM      = 60;
+static constexpr int    DRIVE_PULSE_TICKS     = 3;
+static constexpr int    DRIVE_PULSE_GAP_TICKS = 4;
+static constexpr float  DRIVE_MIN_ERR_DEG     = 20.0f;
+static constexpr int    DRIVE_LAG_NUM         = 3;
+static constexpr int    DRIVE_LAG_DEN         = 4;
+static constexpr flipmath::angle_t DRIVE_MIN_ERR = flipmath::deg(DRIVE_MIN_ERR_DEG);
+
+// Concurrent side recovery: yaw may start once pitch error is below this.
+static constexpr float YAW_GUARD_PITCH_ERR_DEG = 30.0f;
+
+static constexpr FlipController::StepSpec PITCH_UP_YAW_STEP = {
+    /* yaw   */ {true, flipmath::deg(YAW_GUARD_PITCH_ERR_DEG)},
+    /* pitch */ {true, 0},
+};
 
 static void task_flip_controller(void *pvParameters) {
     auto *ctrl = static_cast<FlipController*>(pvParameters);
     while (ctrl->active) {
-#ifdef HOST_SIM
-    integrate_pose_from_pwm();
-#endif
-        ctrl->loop();
+        ctrl->loop();  // the host sim integrates the plant inside loop()
         vTaskDelay(pdMS_TO_TICKS(10));
     }
-    send_yaw_pitch_cmd(0, 0);
+    ctrl->abortRecovery();
     vTaskDelete(NULL);
 }
 
+static void task_flip_params(void *pvParameters) {
+    auto *ctrl = static_cast<FlipController*>(pvParameters);
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(PARAM_POLL_MS));
+        ctrl->serviceFlash();
+    }
+}
+
 FlipController::Orientation
-FlipController::classifyOrientation(float pitchDeg) {
-    if (pitchDeg > 90.0f) return ORIENT_UPSIDE_DOWN;
-    if (pitchDeg < -45.0f) return ORIENT_LEFT;
-    if (pitchDeg > 45.0f) return ORIENT_RIGHT;
+FlipController::classifyOrientation(flipmath::angle_t pitch) {
+    using namespace flipmath;
+    if (ord(pitch) > ord(PITCH_UPSIDE_TH)) return ORIENT_UPSIDE_DOWN;
+    if (ord(pitch) < ord(PITCH_LEFT_TH)) return ORIENT_LEFT;
+    if (ord(pitch) > ord(PITCH_RIGHT_TH)) return ORIENT_RIGHT;
     return ORIENT_UPRIGHT;
 }
 
 void FlipController::checkPosition(void) {
     imu_data_t imu = get_imu_data();
-    curYaw   = normalize_deg((float)imu.yaw   / 100.0f);
-    curPitch = normalize_deg((float)imu.pitch / 100.0f);
+    curYaw   = flipmath::from_centideg(imu.yaw);
+    prevPitch = curPitch;
+    curPitch = flipmath::from_centideg(imu.pitch);
+    curRollCd = imu.roll;
+    pitchRate = flipmath::delta(prevPitch, curPitch);
 }
 
 void FlipController::loop(void) {
@@ -139,76 +162,87 @@ void FlipController::loop(void) {
         integrate_pose_from_pwm();
     #endif
     checkPosition();
+    power.update(DT_MS);
+
+    if (disabled) {
+        // setDisabled() only latches; the flip task stops the flip itself.
+        if (flipInProgress) abortRecovery();
+        return;
+    }
 
     if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
         recoverRequested = true;
     }
     if (recoverRequested && phase == PH_IDLE) {
     Orientation o = classifyOrientation(curPitch);
-    std::printf("[SIM] Detected orientation: %d (pitch=%.1f)\n", (int)o, curPitch);
+    FLIP_LOG("[SIM] Detected orientation: %d (pitch=%.1f)\n", (int)o, flipmath::to_deg(curPitch));
 
     recoverRequested = false;
 
+    // Level without the follow-up side recovery, or back upside down.
+    if (upsidePending && (o == ORIENT_UPRIGHT || o == ORIENT_UPSIDE_DOWN)) {
+        upsidePending = false;
+        recordOutcome(ORIENT_UPSIDE_DOWN, upsideTilt, upsideArm, o == ORIENT_UPRIGHT, upsideTicks);
+    }
+
     if (o == ORIENT_UPRIGHT) {
-        send_yaw_pitch_cmd(0, 0);
+        sendCmd(0, 0);
         return;
     }
 
     flipInProgress = true;
+    flipOrient = o;
+    flipTilt   = StrategyTable::tiltFor(curRollCd);
+    flipTicks  = 0;
+    flipScored = false;
+    flipStrategy = chooseStrategy(o, flipTilt);
+    FLIP_LOG("[SIM] Strategy %d (tilt bucket %d)\n", (int)flipStrategy, (int)flipTilt);
 
     if (o == ORIENT_UPSIDE_DOWN) {
-        tgtPitch = -90.0f;
+        tgtPitch = flipStrategy == STRAT_PITCH_SCORPION ? PITCH_RIGHT_SIDE : PITCH_LEFT_SIDE;
         startSequence({PH_PITCH_DOWN});
     }
-    else if (o == ORIENT_LEFT) {
-            sYawSign = 1;
-            tgtPitch = 0.0f; 
-            tgtYaw = normalize_deg(curYaw + 90.0f); 
-            startSequence({PH_PITCH_UP, PH_YAW_TURN1, PH_PITCH_DOWN});
-    }
-    else if (o == ORIENT_RIGHT) {
-        sYawSign = -1;
-        tgtPitch = 0.0f;
-        tgtYaw = normalize_deg(curYaw - 90.0f);
-        startSequence({PH_PITCH_UP, PH_YAW_TURN1, PH_PITCH_DOWN});
+    else {
+        sYawSign = flipStrategy == STRAT_YAW_RIGHT ? -1 : 1;
+        tgtPitch = PITCH_LEVEL;
+        tgtYaw = flipmath::add(curYaw, sYawSign > 0 ? YAW_QUARTER_LEFT : YAW_QUARTER_RIGHT);
+        if (concurrentPhases) startSequence({PH_PITCH_UP_YAW, PH_PITCH_DOWN});
+        else startSequence({PH_PITCH_UP, PH_YAW_TURN1, PH_PITCH_DOWN});
     }
 
     }
 
     if (!flipInProgress) {
-        send_yaw_pitch_cmd(0, 0);
+        sendCmd(0, 0);
         return;
     }
 
-    const float yawStepMax   = YAW_RATE_DPS   * DT_SEC;
-    const float pitchStepMax = PITCH_RATE_DPS * DT_SEC;
-
-    if (!flipInProgress || currentStepIndex >= sequenceLength) {
-        send_yaw_pitch_cmd(0, 0);
+    if (currentStepIndex >= sequenceLength) {
+        // Sequence ran out without a terminal phase: end the flip.
+        endFlip(true);
         return;
     }
+    flipTicks++;
 
     phase = phaseSequence[currentStepIndex];
     switch (phase) {
     case PH_IDLE:
-        send_yaw_pitch_cmd(0, 0);
-        #ifdef HOST_SIM
-        std::printf("[SIM] Idle: curPitch=%.1f curYaw=%.1f (no recovery in progress)\n", curPitch, curYaw);
-        #endif
+        sendCmd(0, 0);
+        FLIP_LOG("[SIM] Idle: curPitch=%.1f curYaw=%.1f (no recovery in progress)\n",
+                 flipmath::to_deg(curPitch), flipmath::to_deg(curYaw));
         currentStepIndex++;
         break;
 
     case PH_YAW_TURN1: {
-        float yawErr = shortest_delta_deg(curYaw, tgtYaw);
-        int8_t yawCmd = p_cmd(yawErr, KP_YAW, MAX_PWM_YAW, YAW_EPS_DEG);
-        #ifdef HOST_SIM
-        std::printf("[SIM] YAW_TURN1: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n", curYaw, tgtYaw, yawErr, yawCmd);
-        #endif
-        send_yaw_pitch_cmd(yawCmd, 0);
-
-        if (fabsf(yawErr) <= YAW_EPS_DEG) {
-            send_yaw_pitch_cmd(0, 0);
-            tgtPitch = 0.0f;
+        flipmath::angle_t yawErr = flipmath::delta(curYaw, tgtYaw);
+        int8_t yawCmd = flipmath::p_cmd(yawErr, KP_YAW, MAX_PWM_YAW, YAW_EPS);
+        FLIP_LOG("[SIM] YAW_TURN1: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n", flipmath::to_deg(curYaw),
+                 flipmath::to_deg(tgtYaw), flipmath::to_deg(yawErr), yawCmd);
+        sendCmd(yawCmd, 0);
+
+        if (flipmath::within(yawErr, YAW_EPS)) {
+            sendCmd(0, 0);
+            tgtPitch = PITCH_LEVEL;
             currentStepIndex++;  
         }
         break;
@@ -217,34 +251,38 @@ void FlipController::loop(void) {
 
 
     case PH_PITCH_UP: {
-        float pitchErr = shortest_delta_deg(curPitch, tgtPitch);
-        int8_t pitchCmd = p_cmd(pitchErr, KP_PITCH, MAX_PWM_PITCH, PITCH_EPS_DEG);
-        #ifdef HOST_SIM
-        std::printf("[SIM] PITCH_UP: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n", curPitch, tgtPitch, pitchErr, pitchCmd);
-        #endif
-        send_yaw_pitch_cmd(0, pitchCmd);
-
-        if (fabsf(pitchErr) <= PITCH_EPS_DEG) {
-            send_yaw_pitch_cmd(0, 0);
-            tgtPitch = -90.0f;
+        flipmath::angle_t pitchErr = flipmath::delta(curPitch, tgtPitch);
+        int8_t pitchCmd = flipmath::p_cmd(pitchErr, KP_PITCH, MAX_PWM_PITCH, PITCH_EPS);
+        FLIP_LOG("[SIM] PITCH_UP: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n", flipmath::to_deg(curPitch),
+                 flipmath::to_deg(tgtPitch), flipmath::to_deg(pitchErr), pitchCmd);
+        sendCmd(0, pitchCmd);
+
+        if (flipmath::within(pitchErr, PITCH_EPS)) {
+            sendCmd(0, 0);
+            tgtPitch = PITCH_LEFT_SIDE;
             currentStepIndex++;  
         }
         break;
     }
 
+    case PH_PITCH_UP_YAW: {
+        if (runStep(PITCH_UP_YAW_STEP)) {
+            sendCmd(0, 0);
+            tgtPitch = PITCH_LEVEL;
+            currentStepIndex++;
+        }
+        break;
+    }
+
     case PH_PITCH_DOWN: {
-        float nextPitch = step_towards(curPitch, tgtPitch, pitchStepMax);
-        float pitchErr = shortest_delta_deg(curPitch, nextPitch);
-        int8_t pitchCmd = p_cmd(pitchErr, KP_PITCH, MAX_PWM_PITCH, PITCH_EPS_DEG);
-        send_yaw_pitch_cmd(0, pitchCmd);
-
-        if (fabsf(shortest_delta_deg(curPitch, tgtPitch)) <= PITCH_EPS_DEG) {
-            #ifdef HOST_SIM
-            std::printf("[SIM] PITCH_DOWN complete. Ending flip sequence.\n");
-            #endif
-            send_yaw_pitch_cmd(0, 0);
-            flipInProgress = false;
-            phase = PH_IDLE;
+        flipmath::angle_t nextPitch = flipmath::step_towards(curPitch, tgtPitch, PITCH_STEP_MAX);
+        flipmath::angle_t pitchErr = flipmath::delta(curPitch, nextPitch);
+        int8_t pitchCmd = flipmath::p_cmd(pitchErr, KP_PITCH, MAX_PWM_PITCH, PITCH_EPS);
+        sendCmd(0, pitchCmd, driveAssistCmd(pitchErr));
+
+        if (flipmath::within(flipmath::delta(curPitch, tgtPitch), PITCH_EPS)) {
+            FLIP_LOG("[SIM] PITCH_DOWN complete. Ending flip sequence.\n");
+            endFlip(true);
             return;
         }
 
@@ -254,38 +292,146 @@ void FlipController::loop(void) {
 
 case PH_YAW_TURN2:
   {
-    imu_data_t imu = get_imu_data();
-    //float curYaw = normalize_deg((float)imu.yaw / 100.0f);
-    float yawErr = shortest_delta_deg(curYaw, tgtYaw);
-    int yawCmd = p_cmd(yawErr, KP_YAW, MAX_PWM_YAW, YAW_EPS_DEG);
-    #ifdef HOST_SIM
-        std::printf("[SIM] YAW_TURN2: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n",
-                    curYaw, tgtYaw, yawErr, yawCmd);
-    #endif
-    motors_action_t act = {};
-    act.yaw = yawCmd;
-    act.flip_mode = 0;
-    set_motors(&act);
-
-    #ifdef HOST_SIM
-    g_imu.yaw_deg = normalize_deg(g_imu.yaw_deg + (float)yawCmd * DT_SEC);
-    #endif
-
-    if (fabsf(yawErr) <= YAW_EPS_DEG || yawCmd == 0) {
-        motors_action_t stop = {};
-        set_motors(&stop);
-        #ifdef HOST_SIM
-        std::printf("[SIM] YAW_TURN2 complete, switching to IDLE\n");
-        #endif
-        flipInProgress = false;
-        phase = PH_IDLE;  
+    flipmath::angle_t yawErr = flipmath::delta(curYaw, tgtYaw);
+    int yawCmd = flipmath::p_cmd(yawErr, KP_YAW, MAX_PWM_YAW, YAW_EPS);
+    FLIP_LOG("[SIM] YAW_TURN2: cur=%.1f tgt=%.1f err=%.1f cmd=%d\n",
+             flipmath::to_deg(curYaw), flipmath::to_deg(tgtYaw), flipmath::to_deg(yawErr), yawCmd);
+    sendCmd((int8_t)yawCmd, 0);
+
+    if (flipmath::within(yawErr, YAW_EPS) || yawCmd == 0) {
+        sendCmd(0, 0);
+        FLIP_LOG("[SIM] YAW_TURN2 complete, switching to IDLE\n");
+        endFlip(true);
     }
-    currentStepIndex++;
     break;
   }
 
+    default:
+        // Phases with no handler here are skipped rather than stalling the flip.
+        sendCmd(0, 0);
+        currentStepIndex++;
+        break;
+    }
+}
+
+FlipController::Strategy FlipController::strategyFor(Orientation o, int arm) {
+    if (o == ORIENT_UPSIDE_DOWN) return arm ? STRAT_PITCH_SCORPION : STRAT_PITCH_STRAIGHT;
+    return arm ? STRAT_YAW_RIGHT : STRAT_YAW_LEFT;
+}
+
+FlipController::Strategy FlipController::chooseStrategy(Orientation o, StrategyTable::Tilt tilt) {
+    for (int arm = 0; arm < StrategyTable::ARMS; ++arm) {
+        if (strategyOverride == strategyFor(o, arm)) return strategyOverride;
+    }
+    if (!adaptiveStrategy) return strategyFor(o, legacyArm(o));
+    return strategyFor(o, strategies.select(o, tilt, legacyArm(o)));
+}
+
+// Ends the flip in progress and scores its strategy. A completed
+// upside-down flip only reaches a side, so its strategy is scored when the
+// side recovery that follows ends, on the ticks of both flips.
+void FlipController::endFlip(bool completed) {
+    sendCmd(0, 0);
+    flipInProgress = false;
+    phase = PH_IDLE;
+    // Sequences started through startSequence() carry no strategy.
+    if (flipScored || !adaptiveStrategy) return;
+    flipScored = true;
+
+    const int arm = (flipStrategy == STRAT_YAW_RIGHT || flipStrategy == STRAT_PITCH_SCORPION) ? 1 : 0;
+    if (flipOrient == ORIENT_UPSIDE_DOWN && completed) {
+        upsidePending = true;
+        upsideTilt    = flipTilt;
+        upsideArm     = arm;
+        upsideTicks   = flipTicks;
+        return;
+    }
+    recordOutcome(flipOrient, flipTilt, arm, completed, flipTicks);
+    if (upsidePending && flipOrient != ORIENT_UPSIDE_DOWN) {
+        upsidePending = false;
+        recordOutcome(ORIENT_UPSIDE_DOWN, upsideTilt, upsideArm, completed, upsideTicks + flipTicks);
+    }
+}
+
+// Every StrategyTable::SAVE_EVERY outcomes a save is flagged for
+// serviceFlash().
+void FlipController::recordOutcome(Orientation o, StrategyTable::Tilt tilt, int arm,
+                                   bool completed, uint32_t ticks) {
+    strategies.record(o, tilt, arm, StrategyTable::rewardFor(completed, ticks));
+    if (strategies.saveDue()) savePending = true;
+}
+
+// A sector erase blocks for tens of ms, so this runs in the low-priority
+// params task and never in the 10 ms loop. The snapshot is taken with the
+// flip task locked out; the slow write works on the copy.
+void FlipController::serviceFlash() {
+    if (!savePending || flipInProgress) return;
+    taskENTER_CRITICAL();
+    StrategyTable snapshot = strategies;
+    strategies.markSaved();
+    savePending = false;
+    taskEXIT_CRITICAL();
+    if (!snapshot.save()) savePending = true;  // retried on the next poll
+}
+
+// Every command goes through the thermal/battery budget, and the budget
+// accounts for it from the next tick on.
+void FlipController::sendCmd(int8_t yawPwm, int8_t pitchPwm, int8_t drivePwm) {
+    power.limit(yawPwm, pitchPwm, drivePwm);
+    power.observe(yawPwm, pitchPwm, drivePwm);
+    send_motor_cmd(yawPwm, pitchPwm, drivePwm);
+}
 
+int8_t FlipController::driveAssistCmd(flipmath::angle_t trajStep) {
+    using namespace flipmath;
+    if (!driveAssist || within(delta(curPitch, tgtPitch), DRIVE_MIN_ERR)) {
+        drivePulseLeft = 0;
+        return 0;
+    }
+    if (drivePulseLeft > 0) {
+        --drivePulseLeft;
+        return (int8_t)(drivePulseSign * DRIVE_ASSIST_PWM);
+    }
+    if (driveGapLeft > 0) {
+        --driveGapLeft;
+        return 0;
     }
+    // On the first tick the rate spans the time before the flip (a pose
+    // jump, or a half turn that is +180 in float and -180 in BAMS), not
+    // how the body follows the trajectory.
+    if (flipTicks <= 1) return 0;
+
+    // Rate along the trajectory direction, compared with the planned step.
+    auto along = (trajStep > 0) ? pitchRate : -pitchRate;
+    if (along * DRIVE_LAG_DEN >= mag(trajStep) * DRIVE_LAG_NUM) return 0;
+
+    drivePulseSign = (trajStep > 0) ? 1 : -1;
+    drivePulseLeft = DRIVE_PULSE_TICKS - 1;
+    driveGapLeft   = DRIVE_PULSE_GAP_TICKS;
+    FLIP_LOG("[SIM] drive pulse: pitch=%.1f rate=%.2f step=%.2f\n",
+             to_deg(curPitch), to_deg(pitchRate), to_deg(trajStep));
+    return (int8_t)(drivePulseSign * DRIVE_ASSIST_PWM);
+}
+
+bool FlipController::runStep(const StepSpec& step) {
+    using namespace flipmath;
+    angle_t yawErr   = delta(curYaw, tgtYaw);
+    angle_t pitchErr = delta(curPitch, tgtPitch);
+
+    bool yawGo   = step.yaw.drive &&
+                   (step.yaw.guard == 0 || within(pitchErr, step.yaw.guard));
+    bool pitchGo = step.pitch.drive &&
+                   (step.pitch.guard == 0 || within(yawErr, step.pitch.guard));
+
+    int8_t yawCmd   = yawGo   ? flipmath::p_cmd(yawErr, KP_YAW, MAX_PWM_YAW, YAW_EPS) : 0;
+    int8_t pitchCmd = pitchGo ? flipmath::p_cmd(pitchErr, KP_PITCH, MAX_PWM_PITCH, PITCH_EPS) : 0;
+    FLIP_LOG("[SIM] STEP: yaw cur=%.1f tgt=%.1f cmd=%d | pitch cur=%.1f tgt=%.1f cmd=%d\n",
+             to_deg(curYaw), to_deg(tgtYaw), yawCmd, to_deg(curPitch), to_deg(tgtPitch), pitchCmd);
+    sendCmd(yawCmd, pitchCmd);
+
+    bool yawDone   = !step.yaw.drive   || within(yawErr, YAW_EPS);
+    bool pitchDone = !step.pitch.drive || within(pitchErr, PITCH_EPS);
+    return yawDone && pitchDone;
 }
 
 void FlipController::setEnabled(void) {
@@ -295,6 +441,7 @@ void FlipController::setEnabled(void) {
         flipInProgress = false;
         recoverRequested = false;
         sYawSign = 0;
+        disabled = false;
 
         xTaskCreate(
             task_flip_controller,
@@ -304,12 +451,43 @@ void FlipController::setEnabled(void) {
             configMAX_PRIORITIES - 2,
             &sFlipTaskHandle
         );
+        // One params task and one load per controller: a save pending at
+        // disable time still lands, and from then on RAM is newer than flash.
+        if (!paramsTaskStarted) {
+            paramsTaskStarted = true;
+            strategies.load();
+            xTaskCreate(
+                task_flip_params,
+                "flip_params",
+                512U,
+                this,
+                tskIDLE_PRIORITY + 1,
+                nullptr
+            );
+        }
     }
 }
 
+// Only latches: the flip task stops any flip on its next tick (or on its
+// way out), so the controller state is never changed under it.
 void FlipController::setDisabled(void) {
     active = false;
-    send_yaw_pitch_cmd(0, 0);
+    disabled = true;
+}
+
+void FlipController::abortRecovery(bool scoreAsFailure) {
+    if (flipInProgress) {
+        if (scoreAsFailure) endFlip(false);
+        else upsidePending = false;  // nor the upside-down flip it was following up
+    }
+    recoverRequested = false;
+    flipInProgress = false;
+    phase = PH_IDLE;
+    sequenceLength = 0;
+    currentStepIndex = 0;
+    drivePulseLeft = 0;
+    driveGapLeft = 0;
+    sendCmd(0, 0);
 }
 
 void FlipController::triggerRecovery() {
@@ -331,25 +509,34 @@ void FlipController::triggerRecoveryFromISR() {
 }
 
 #ifdef HOST_SIM
-static motors_action_t get_last_motor_cmd() {
-    return last_motor_cmd;
-}
-
+// The plant moves with whatever the motors run, not only this controller's
+// commands.
 static void integrate_pose_from_pwm() {
-    motors_action_t act = get_last_motor_cmd();
-
-    float pitch_change = (float)act.pitch * DT_SEC * PITCH_RATE_DPS;
-    float yaw_change   = (float)act.yaw   * DT_SEC * YAW_RATE_DPS;
-
-    g_imu.pitch_deg = normalize_deg(g_imu.pitch_deg + pitch_change);
-    g_imu.yaw_deg   = normalize_deg(g_imu.yaw_deg + yaw_change);
+    sim_plant_step(g_sim_motors, DT_SEC);
 }
 #endif
 
 
 void FlipController::startSequence(std::initializer_list<phase_t> seq) {
-    sequenceLength = seq.size();
-    std::copy(seq.begin(), seq.end(), phaseSequence);
+    startSequence(seq.begin(), (int)seq.size());
+}
+
+void FlipController::startSequence(const phase_t* seq, int len) {
+    // loop() returns before the sequence code while disabled, so a flip
+    // started now would never run or end.
+    if (disabled) {
+        FLIP_LOG("[SIM] startSequence: controller disabled, ignored\n");
+        return;
+    }
+    if (len < 0 || len > MAX_SEQUENCE) {
+        FLIP_LOG("[SIM] startSequence: %d phases exceeds capacity %d, ignored\n", len, MAX_SEQUENCE);
+        abortRecovery();
+        return;
+    }
+    sequenceLength = len;
+    std::copy(seq, seq + len, phaseSequence);
     currentStepIndex = 0;
+    drivePulseLeft = 0;
+    driveGapLeft = 0;
     flipInProgress = true;
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include <stdint.h>
-#include <math.h>
 #include "imu/imu.h"
+#include "FlipMath.h"
+#include "PowerBudget.h"
+#include "StrategyTable.h"
 #include <initializer_list>
 
 extern "C" {
@@ -26,6 +28,9 @@ public:
   void checkPosition(void);
   void triggerRecovery();
   void triggerRecoveryFromISR();
+  // Stops the flip in progress. Operator aborts leave its strategy unscored;
+  // harnesses that give up on a flip (timeouts) score it as a failure.
+  void abortRecovery(bool scoreAsFailure = false);
 
   enum Phase : uint8_t {
     PH_IDLE = 0,
@@ -35,12 +40,52 @@ public:
     PH_PITCH_DOWN,
     PH_YAW_TURN1,
     PH_PITCH_UP,
-    PH_YAW_TURN2
+    PH_YAW_TURN2,
+    PH_PITCH_UP_YAW
   };
 
   using phase_t = Phase;
 
+  static constexpr int    MAX_SEQUENCE  = 8;
+  static constexpr int8_t MAX_PWM_YAW   = 100;
+  static constexpr int8_t MAX_PWM_PITCH = 100;
+  static constexpr int8_t MAX_PWM_DRIVE = 100;
+
   void startSequence(std::initializer_list<phase_t> seq);
+  // Sequences longer than MAX_SEQUENCE are rejected and abort the flip.
+  // Ignored while the controller is disabled.
+  void startSequence(const phase_t* seq, int len);
+
+  // Side recovery: drive pitch-up and yaw-turn in one concurrent step
+  // (default) or as the legacy strictly sequential phases.
+  void setConcurrentPhases(bool on) { concurrentPhases = on; }
+  // Timed drive-train pulses add momentum during PH_PITCH_DOWN (default on).
+  void setDriveAssist(bool on) { driveAssist = on; }
+  bool busy() const { return flipInProgress; }
+  Phase currentPhase() const { return phase; }
+
+  // Thermal/battery budget; accounting always runs, clamping can be disabled.
+  void setPowerBudget(bool enforce) { power.setEnforced(enforce); }
+  const PowerBudget& powerBudget() const { return power; }
+  // Code that drives the flip motors itself (teleop, drive train) reports
+  // each new command here, 0 when it stops, so heat from outside a flip is
+  // counted too (PowerBudget::observeExternal).
+  void observeMotorCmd(int8_t yawPwm, int8_t pitchPwm, int8_t drivePwm) {
+    power.observeExternal(yawPwm, pitchPwm, drivePwm);
+  }
+
+  // Per-axis behaviour of a step. A driven axis with a non-zero guard is
+  // held at zero until the other axis error is within guard.
+  struct AxisStep {
+    bool               drive;
+    flipmath::angle_t  guard;
+  };
+
+  // A step completes once every driven axis is inside its epsilon.
+  struct StepSpec {
+    AxisStep yaw;
+    AxisStep pitch;
+  };
 
   enum Orientation : uint8_t {
     ORIENT_UPRIGHT = 0,
@@ -49,7 +94,31 @@ public:
     ORIENT_UPSIDE_DOWN
   };
 
-  phase_t phaseSequence[8] = {};
+  // Side recoveries choose the yaw direction, upside-down recoveries the
+  // pitch direction (straight through vs scorpion over the back). An
+  // upside-down strategy is scored on the time to level, its own flip plus
+  // the side recovery that follows.
+  enum Strategy : uint8_t {
+    STRAT_YAW_LEFT = 0,    // side: yaw +90
+    STRAT_YAW_RIGHT,       // side: yaw -90
+    STRAT_PITCH_STRAIGHT,  // upside down: pitch to -90
+    STRAT_PITCH_SCORPION,  // upside down: pitch to +90
+    STRAT_AUTO = 0xFF
+  };
+
+  // Learned strategy selection (default on). Off, each orientation uses its
+  // legacy strategy. An override forces a strategy wherever it applies.
+  void setAdaptiveStrategy(bool on) { adaptiveStrategy = on; }
+  void setStrategyOverride(Strategy s) { strategyOverride = s; }
+  Strategy lastStrategy() const { return flipStrategy; }
+  StrategyTable& strategyStats() { return strategies; }
+  // Writes the strategy table to parameter flash if a save is pending and no
+  // flip is running. Called from the low-priority params task; headless
+  // harnesses call it between episodes.
+  void serviceFlash();
+  bool flashSavePending() const { return savePending; }
+
+  phase_t phaseSequence[MAX_SEQUENCE] = {};
   int sequenceLength = 0;
   int currentStepIndex = 0;
   volatile bool active = false;
@@ -59,53 +128,51 @@ private:
   RSBL8512& pitch;
 
   Phase phase = PH_IDLE;
+  PowerBudget power;
+  StrategyTable strategies;
 
-  float curYaw   = 0.0f;
-  float curPitch = 0.0f;
-  float tgtYaw   = 0.0f;
-  float tgtPitch = 0.0f;
-
-  const float yawRateDegPerSec   = 90.0f;
-  const float pitchRateDegPerSec = 120.0f;
-  const float yawEps             = 1.0f;
-  const float pitchEps           = 1.0f;
-  const float dt                 = 0.010f;
+  flipmath::angle_t curYaw   = 0;
+  flipmath::angle_t curPitch = 0;
+  flipmath::angle_t tgtYaw   = 0;
+  flipmath::angle_t tgtPitch = 0;
+  flipmath::angle_t prevPitch = 0;
+  flipmath::angle_t pitchRate = 0;  // IMU pitch change over the last tick
+  int32_t curRollCd = 0;            // terrain cross-slope, centideg
 
   bool flipInProgress   = false;
   bool recoverRequested = false;
-
-  static Orientation classifyOrientation(float pitchDeg);
-
-  // --------- Helpers ---------
-  static inline float normalizeDeg(float d) {
-    while (d > 180.0f) d -= 360.0f;
-    while (d < -180.0f) d += 360.0f;
-    return d;
-  }
-
-  static inline float shortestDelta(float fromDeg, float toDeg) {
-    return normalizeDeg(toDeg - fromDeg);
-  }
-
-  static inline float stepTowards(float cur, float tgt, float maxStep) {
-    float d = shortestDelta(cur, tgt);
-    if (fabsf(d) <= maxStep) return tgt;
-    return normalizeDeg(cur + ((d > 0.f) ? maxStep : -maxStep));
-  }
-
-  static inline int8_t p_cmd(float err, float kp, int8_t maxPwm, float eps) {
-    if (fabsf(err) <= eps) return 0;
-    float u = kp * err;
-    if (u >  maxPwm) u =  maxPwm;
-    if (u < -maxPwm) u = -maxPwm;
-    return (int8_t)u;
-  }
-
-  void sendCmd(int8_t yawPwm, int8_t pitchPwm);
-
-  static constexpr float KP_YAW         = 1.0f;
-  static constexpr float KP_PITCH       = 1.0f;
-  static constexpr int8_t MAX_PWM_YAW   = 100;
-  static constexpr int8_t MAX_PWM_PITCH = 100;
-  static constexpr float SCORPION_DEG   = 45.0f;
+  bool concurrentPhases = true;
+  volatile bool disabled = false;  // latched by setDisabled(); loop() stops the flip, then stays silent
+  bool driveAssist      = true;
+  bool adaptiveStrategy = true;
+  volatile bool savePending = false;  // set by endFlip(), cleared by serviceFlash()
+  bool paramsTaskStarted = false;     // the params task, started once and never deleted
+
+  // Outcome bookkeeping for the flip in progress.
+  Strategy            strategyOverride = STRAT_AUTO;
+  Strategy            flipStrategy     = STRAT_AUTO;
+  Orientation         flipOrient       = ORIENT_UPRIGHT;
+  StrategyTable::Tilt flipTilt         = StrategyTable::TILT_FLAT;
+  uint32_t            flipTicks        = 0;
+  bool                flipScored       = true;
+  // A completed upside-down flip, waiting for its follow-up side recovery.
+  bool                upsidePending    = false;
+  StrategyTable::Tilt upsideTilt       = StrategyTable::TILT_FLAT;
+  int                 upsideArm        = 0;
+  uint32_t            upsideTicks      = 0;
+
+  int8_t drivePulseSign = 0;
+  int    drivePulseLeft = 0;
+  int    driveGapLeft   = 0;
+
+  static Orientation classifyOrientation(flipmath::angle_t pitch);
+  static Strategy strategyFor(Orientation o, int arm);
+  static int legacyArm(Orientation o) { return o == ORIENT_RIGHT ? 1 : 0; }
+  Strategy chooseStrategy(Orientation o, StrategyTable::Tilt tilt);
+  void endFlip(bool completed);
+  void recordOutcome(Orientation o, StrategyTable::Tilt tilt, int arm, bool completed, uint32_t ticks);
+
+  void sendCmd(int8_t yawPwm, int8_t pitchPwm, int8_t drivePwm = 0);
+  bool runStep(const StepSpec& step);
+  int8_t driveAssistCmd(flipmath::angle_t trajStep);
 };
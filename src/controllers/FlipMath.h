@@ -0,0 +1,133 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Angle and P-control arithmetic for FlipController, selected at compile time.
+//
+//   FLIP_FIXED_POINT=0 (default): float degrees in (-180, 180].
+//   FLIP_FIXED_POINT=1: 16-bit binary angle units (BAMS, 65536 per turn).
+//     Wrap-around is int16 overflow, gains are Q16.16 PWM per BAM, and the
+//     control path needs no FPU (so the flip task has no FP context to save).
+//
+// Both namespaces are always compiled so host tools can compare them.
+// flip_fixed_test checks the helpers call by call; flip_equiv runs whole
+// flips in both builds. Closed loop they match except where a measured rate
+// lands exactly on the drive-assist lag threshold: float and BAMS break that
+// tie differently, which shifts one pulse train by a tick or two.
+
+#ifndef FLIP_FIXED_POINT
+#define FLIP_FIXED_POINT 0
+#endif
+
+namespace flipmath {
+
+// ----------------------- float degrees -----------------------
+namespace flt {
+
+typedef float angle_t;
+typedef float gain_t;
+
+static constexpr angle_t deg(float d) { return d; }
+static constexpr gain_t  gain(float kp) { return kp; }
+static inline    float   to_deg(angle_t a) { return a; }
+
+static inline angle_t wrap(angle_t a) {
+  while (a <= -180.0f) a += 360.0f;
+  while (a > 180.0f) a -= 360.0f;
+  return a;
+}
+
+static inline angle_t from_centideg(int32_t cd) { return wrap((float)cd / 100.0f); }
+static inline angle_t add(angle_t a, angle_t b) { return wrap(a + b); }
+
+static inline angle_t delta(angle_t from, angle_t to) {
+  float diff = to - from;
+  while (diff < -180.0f) diff += 360.0f;
+  while (diff > 180.0f) diff -= 360.0f;
+  return diff;
+}
+
+static inline bool  within(angle_t err, angle_t eps) { return fabsf(err) <= eps; }
+static inline float mag(angle_t a) { return fabsf(a); }
+
+// Ordering key; +180 sorts above everything else.
+static inline float ord(angle_t a) { return a; }
+
+static inline angle_t step_towards(angle_t cur, angle_t tgt, angle_t maxStep) {
+  angle_t d = delta(cur, tgt);
+  if (d >  maxStep) return wrap(cur + maxStep);
+  if (d < -maxStep) return wrap(cur - maxStep);
+  return wrap(tgt);
+}
+
+// Proportional command, truncated toward zero.
+static inline int8_t p_cmd(angle_t err, gain_t kp, int8_t maxPwm, angle_t eps) {
+  if (fabsf(err) <= eps) return 0;
+  float u = kp * err;
+  if (u >  maxPwm) u =  maxPwm;
+  if (u < -maxPwm) u = -maxPwm;
+  return (int8_t)u;
+}
+
+}  // namespace flt
+
+// ------------------------ fixed point ------------------------
+namespace fx {
+
+typedef int16_t angle_t;  // BAMS
+typedef int32_t gain_t;   // Q16.16 PWM per BAM
+
+static constexpr angle_t deg(float d) {
+  return (angle_t)(int32_t)(d * (65536.0f / 360.0f) + (d < 0.0f ? -0.5f : 0.5f));
+}
+
+// kp [PWM/deg] * 360/65536 [deg/BAM], stored with 16 fractional bits.
+static constexpr gain_t gain(float kp) { return (gain_t)(kp * 360.0f + 0.5f); }
+
+static inline float to_deg(angle_t a) { return (float)a * (360.0f / 65536.0f); }
+
+// 65536/36000 in Q16, rounded; the int16 cast does the wrap.
+static inline angle_t from_centideg(int32_t cd) {
+  return (angle_t)(int32_t)(((int64_t)cd * 119305 + 0x8000) >> 16);
+}
+
+static inline angle_t wrap(angle_t a) { return a; }
+static inline angle_t add(angle_t a, angle_t b) { return (angle_t)(a + b); }
+static inline angle_t delta(angle_t from, angle_t to) { return (angle_t)(to - from); }
+
+static inline bool within(angle_t err, angle_t eps) {
+  int32_t e = err;
+  return (e < 0 ? -e : e) <= eps;
+}
+
+static inline int32_t mag(angle_t a) { int32_t v = a; return v < 0 ? -v : v; }
+static inline int32_t ord(angle_t a) { return a == INT16_MIN ? 32768 : a; }
+
+static inline angle_t step_towards(angle_t cur, angle_t tgt, angle_t maxStep) {
+  angle_t d = delta(cur, tgt);
+  if (d >  maxStep) return (angle_t)(cur + maxStep);
+  if (d < -maxStep) return (angle_t)(cur - maxStep);
+  return tgt;
+}
+
+static inline int8_t p_cmd(angle_t err, gain_t kp, int8_t maxPwm, angle_t eps) {
+  if (within(err, eps)) return 0;
+  // err is the difference of two rounded conversions, so it can sit up to
+  // one BAM short of the centidegree value the float path sees; crediting
+  // that BAM keeps exact PWM boundaries on the same side as in float.
+  int32_t u = (int32_t)err * kp;
+  u = (u >= 0) ? ((u + kp) >> 16) : -((-u + kp) >> 16);
+  if (u >  maxPwm) u =  maxPwm;
+  if (u < -maxPwm) u = -maxPwm;
+  return (int8_t)u;
+}
+
+}  // namespace fx
+
+#if FLIP_FIXED_POINT
+using namespace fx;
+#else
+using namespace flt;
+#endif
+
+}  // namespace flipmath
@@ -0,0 +1,91 @@
+#include "PowerBudget.h"
+
+// RSBL8512 joint servos and the drive train; datasheet-level placeholders.
+static constexpr PowerBudget::MotorSpec YAW_SPEC   = {3000,  1200, 3000};
+static constexpr PowerBudget::MotorSpec PITCH_SPEC = {3000,  1200, 3000};
+static constexpr PowerBudget::MotorSpec DRIVE_SPEC = {25000, 6000, 2000};
+
+static inline int32_t abs_i32(int32_t v) { return v < 0 ? -v : v; }
+
+static inline int8_t clamp_pwm(int8_t pwm, int32_t maxAbs) {
+    if (pwm >  maxAbs) return (int8_t)maxAbs;
+    if (pwm < -maxAbs) return (int8_t)-maxAbs;
+    return pwm;
+}
+
+PowerBudget::PowerBudget() {
+    spec[M_YAW]   = YAW_SPEC;
+    spec[M_PITCH] = PITCH_SPEC;
+    spec[M_DRIVE] = DRIVE_SPEC;
+}
+
+int32_t PowerBudget::currentMa(Motor m, int8_t pwm) const {
+    return abs_i32(pwm) * spec[m].stallMa / 100;
+}
+
+int64_t PowerBudget::tripLimit(Motor m) const {
+    const int64_t s = spec[m].stallMa, c = spec[m].contMa;
+    return (s * s - c * c) * spec[m].peakMs;
+}
+
+int32_t PowerBudget::allowedMa(Motor m) const {
+    const int64_t lim   = tripLimit(m);
+    const int64_t start = lim * DERATE_START_PCT / 100;
+    if (heat[m] <= start) return spec[m].stallMa;
+    if (heat[m] >= lim)   return spec[m].contMa;
+    const int64_t span = spec[m].stallMa - spec[m].contMa;
+    return spec[m].contMa + (int32_t)(span * (lim - heat[m]) / (lim - start));
+}
+
+void PowerBudget::observe(int8_t yaw, int8_t pitch, int8_t drive) {
+    applied[M_YAW]   = yaw;
+    applied[M_PITCH] = pitch;
+    applied[M_DRIVE] = drive;
+}
+
+void PowerBudget::observeExternal(int8_t yaw, int8_t pitch, int8_t drive) {
+    external[M_YAW]   = yaw;
+    external[M_PITCH] = pitch;
+    external[M_DRIVE] = drive;
+}
+
+void PowerBudget::update(int32_t dtMs) {
+    int32_t totalMa = 0;
+    for (int i = 0; i < M_COUNT; ++i) {
+        const Motor m = (Motor)i;
+        const int8_t own = applied[i], ext = external[i];
+        const int64_t ia = currentMa(m, abs_i32(ext) > abs_i32(own) ? ext : own);
+        const int64_t ic = spec[m].contMa;
+        heat[m] += (ia * ia - ic * ic) * dtMs;
+        if (heat[m] < 0) heat[m] = 0;
+        totalMa += (int32_t)ia;
+    }
+    // mV * mA = uW; * ms = nJ
+    energyNj += (int64_t)BATTERY_MV * totalMa * dtMs;
+}
+
+void PowerBudget::limit(int8_t& yaw, int8_t& pitch, int8_t& drive) const {
+    if (!enforced) return;
+
+    int8_t* const cmd[M_COUNT] = {&yaw, &pitch, &drive};
+    for (int i = 0; i < M_COUNT; ++i) {
+        const Motor m = (Motor)i;
+        *cmd[i] = clamp_pwm(*cmd[i], allowedMa(m) * 100 / spec[m].stallMa);
+    }
+
+    static const Motor PRIORITY[M_COUNT] = {M_PITCH, M_YAW, M_DRIVE};
+    int32_t leftMa = batteryLimitMa;
+    for (Motor m : PRIORITY) {
+        int8_t& c = *cmd[m];
+        int32_t need = currentMa(m, c);
+        if (need > leftMa) {
+            c = clamp_pwm(c, leftMa * 100 / spec[m].stallMa);
+            need = currentMa(m, c);
+        }
+        leftMa -= need;
+    }
+}
+
+int32_t PowerBudget::heatPermille(Motor m) const {
+    return (int32_t)(heat[m] * 1000 / tripLimit(m));
+}
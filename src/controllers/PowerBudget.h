@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+
+// Per-motor I^2t thermal model plus a battery-current budget for the flip
+// motors. Integer only (mA, ms), so it costs no FPU time in the flip task.
+//
+// Current is modelled as |PWM| / 100 * stall current. Each motor's heat
+// accumulator integrates (I^2 - Icont^2) * dt, floored at zero, against a
+// trip limit of (Istall^2 - Icont^2) * peak time. Above DERATE_START_PCT of
+// that limit the allowed current falls linearly to Icont. The battery budget
+// is then shared in priority order pitch, yaw, drive, so the flip axis keeps
+// its torque and the drive-train assist is the first to give way.
+class PowerBudget {
+public:
+  enum Motor : uint8_t { M_YAW = 0, M_PITCH, M_DRIVE, M_COUNT };
+
+  struct MotorSpec {
+    int32_t stallMa;
+    int32_t contMa;
+    int32_t peakMs;  // time at stall current that reaches the trip limit
+  };
+
+  static constexpr int32_t DERATE_START_PCT = 70;
+  static constexpr int32_t BATTERY_MV       = 24000;
+  static constexpr int32_t BATTERY_LIMIT_MA = 20000;
+
+  PowerBudget();
+
+  // Records the flip task's own command; it holds until the next one.
+  void observe(int8_t yaw, int8_t pitch, int8_t drive);
+
+  // Records a command another task (teleop, drive train) sent. It holds
+  // until that task reports another (0 when it lets go), and the flip task's
+  // own commands, idle zeros included, never overwrite it. Single-byte
+  // stores, so callers need no lock.
+  void observeExternal(int8_t yaw, int8_t pitch, int8_t drive);
+
+  // Accounts for the larger of the two commands per motor over the last dtMs.
+  void update(int32_t dtMs);
+
+  // Clamps a requested command to the thermal and battery limits.
+  void limit(int8_t& yaw, int8_t& pitch, int8_t& drive) const;
+
+  void setEnforced(bool on) { enforced = on; }
+  void setBatteryLimitMa(int32_t ma) { batteryLimitMa = ma; }
+
+  // Heat as per-mille of the trip limit (may exceed 1000 when not enforced).
+  int32_t heatPermille(Motor m) const;
+  int64_t energyNanoJ() const { return energyNj; }
+
+private:
+  MotorSpec spec[M_COUNT];
+  int64_t   heat[M_COUNT]  = {};  // mA^2 * ms above continuous
+  volatile int8_t applied[M_COUNT]  = {};
+  volatile int8_t external[M_COUNT] = {};
+  int64_t   energyNj       = 0;
+  int32_t   batteryLimitMa = BATTERY_LIMIT_MA;
+  bool      enforced       = true;
+
+  int64_t tripLimit(Motor m) const;
+  int32_t allowedMa(Motor m) const;
+  int32_t currentMa(Motor m, int8_t pwm) const;
+};
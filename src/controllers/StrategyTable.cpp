@@ -0,0 +1,144 @@
+#include "StrategyTable.h"
+#include <string.h>
+#include "flash/flash.h"
+#include "fsl_flexspi.h"
+#include "flexspi/flexspi_nor_flash_ops.h"
+
+namespace {
+
+struct FlashBlob {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t crc;  // CRC-16/CCITT over cells
+  StrategyTable::Cell cells[StrategyTable::ORIENTS][StrategyTable::TILT_COUNT][StrategyTable::ARMS];
+};
+
+uint16_t crc16_ccitt(const uint8_t* p, int len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)(*p++ << 8);
+    for (int b = 0; b < 8; ++b) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+// ln(1 + k/32) in Q16, for the mantissa bits below the leading one.
+const uint16_t LN_MANTISSA_Q16[32] = {
+    0,     2017,  3973,  5873,  7719,  9515,  11262, 12965,
+    14624, 16242, 17821, 19364, 20870, 22343, 23783, 25193,
+    26573, 27924, 29248, 30546, 31818, 33067, 34292, 35494,
+    36675, 37835, 38975, 40095, 41196, 42280, 43345, 44394};
+constexpr uint32_t LN2_Q16 = 45426;
+
+// ln(x) in Q16 for x >= 1, low by at most ln(33/32) = 0.03.
+uint32_t ln_q16(uint32_t x) {
+  int msb = 0;
+  while (x >> (msb + 1)) ++msb;
+  const uint32_t frac = msb >= 5 ? (x >> (msb - 5)) & 31u : (x << (5 - msb)) & 31u;
+  return (uint32_t)msb * LN2_Q16 + LN_MANTISSA_Q16[frac];
+}
+
+uint32_t isqrt32(uint32_t x) {
+  uint32_t r = 0, bit = 1u << 30;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= r + bit) {
+      x -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return r;
+}
+
+// Offset of the table's sector in external flash, or -1 if the board's map
+// places it where a sector erase cannot take it alone.
+int flash_addr() {
+  const int addr = ext_map_addr(StrategyTable::FLASH_REGION);
+  if (addr < 0 || addr % StrategyTable::FLASH_SECTOR) return -1;
+  return addr;
+}
+
+}  // namespace
+
+StrategyTable::Tilt StrategyTable::tiltFor(int32_t rollCentideg) {
+  if (rollCentideg <= -TILT_FLAT_CD) return TILT_NEG;
+  if (rollCentideg >=  TILT_FLAT_CD) return TILT_POS;
+  return TILT_FLAT;
+}
+
+uint16_t StrategyTable::rewardFor(bool completed, uint32_t ticks) {
+  if (!completed) return 0;
+  return (uint16_t)(1000u * REWARD_REF_TICKS / (REWARD_REF_TICKS + ticks));
+}
+
+int StrategyTable::select(uint8_t orient, Tilt tilt, int preferredArm) const {
+  if (orient >= ORIENTS || tilt >= TILT_COUNT) return preferredArm;
+  const Cell* c = cells[orient][tilt];
+  if (c[preferredArm].n == 0) return preferredArm;
+
+  uint32_t total = 0;
+  for (int a = 0; a < ARMS; ++a) {
+    if (c[a].n == 0) return a;
+    total += c[a].n;
+  }
+
+  // Per-mille in Q8: mean + C * sqrt(ln(total) / n). With n <= COUNT_CAP
+  // every term fits in 32 bits.
+  const uint32_t lnTotal = ln_q16(total);
+  int      best      = 0;
+  uint32_t bestScore = 0;
+  for (int a = 0; a < ARMS; ++a) {
+    const uint32_t mean  = (c[a].rewardSum << 8) / c[a].n;
+    const uint32_t root  = isqrt32((lnTotal << 8) / c[a].n);  // Q12
+    const uint32_t score = mean + ((UCB_C_PERMILLE * root) >> 4);
+    if (a == 0 || score > bestScore) { bestScore = score; best = a; }
+  }
+  return best;
+}
+
+void StrategyTable::record(uint8_t orient, Tilt tilt, int arm, uint16_t rewardPermille) {
+  if (orient >= ORIENTS || tilt >= TILT_COUNT || arm < 0 || arm >= ARMS) return;
+  Cell& c = cells[orient][tilt][arm];
+  if (c.n >= COUNT_CAP) {
+    c.n /= 2;
+    c.rewardSum /= 2;
+  }
+  c.n++;
+  c.rewardSum += rewardPermille;
+  unsaved++;
+}
+
+void StrategyTable::reset() {
+  memset(cells, 0, sizeof(cells));
+  unsaved = 0;
+}
+
+bool StrategyTable::load() {
+  const int addr = flash_addr();
+  if (addr < 0) return false;
+  FlashBlob blob;
+  if (flash_read(addr, &blob, (int)sizeof(blob)) != 0) return false;
+  if (blob.magic != FLASH_MAGIC || blob.version != FLASH_VERSION) return false;
+  if (blob.crc != crc16_ccitt(reinterpret_cast<const uint8_t*>(blob.cells), (int)sizeof(blob.cells))) return false;
+  memcpy(cells, blob.cells, sizeof(cells));
+  unsaved = 0;
+  return true;
+}
+
+bool StrategyTable::save() {
+  const int addr = flash_addr();
+  if (addr < 0) return false;
+  FlashBlob blob;
+  blob.magic   = FLASH_MAGIC;
+  blob.version = FLASH_VERSION;
+  memcpy(blob.cells, cells, sizeof(cells));
+  blob.crc = crc16_ccitt(reinterpret_cast<const uint8_t*>(blob.cells), (int)sizeof(blob.cells));
+  static_assert(sizeof(blob) <= FLASH_SECTOR, "strategy table exceeds its sector");
+  if (flexspi_nor_flash_erase_sector(FLEXSPI, (uint32_t)addr) != kStatus_Success) return false;
+  if (flash_write(addr, &blob, (int)sizeof(blob)) != 0) return false;
+  unsaved = 0;
+  return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+
+// Outcome statistics for recovery strategies, kept per (orientation,
+// terrain-tilt bucket, arm) and chosen with UCB1. Each orientation offers
+// ARMS alternative strategies; what an arm means is up to the caller.
+//
+// Reward is per-mille, 1000 * REWARD_REF_TICKS / (REWARD_REF_TICKS + ticks)
+// for a completed flip and 0 for an aborted one, so faster is better and
+// failure is worst. Counts are halved once a cell reaches COUNT_CAP, which
+// bounds the stored sums and lets old terrain fade out.
+//
+// Selection is integer only, like the rest of the flip task's hot path.
+//
+// The table is a fixed-size POD blob (magic, version, CRC-16) that owns one
+// erase sector of external flash, the FLASH_REGION entry of the board's
+// flash map. It is loaded at enable time. Once SAVE_EVERY outcomes are
+// pending it is written back (FlexSPI NOR sector erase, then program) from
+// a low-priority context, never from the control loop.
+class StrategyTable {
+public:
+  static constexpr int ORIENTS = 4;  // FlipController::Orientation
+  static constexpr int ARMS    = 2;
+
+  enum Tilt : uint8_t { TILT_NEG = 0, TILT_FLAT, TILT_POS, TILT_COUNT };
+
+  static constexpr int32_t  TILT_FLAT_CD     = 500;   // |roll| below this is flat
+  static constexpr uint32_t REWARD_REF_TICKS = 50;
+  static constexpr uint16_t COUNT_CAP        = 1024;
+  static constexpr int      SAVE_EVERY       = 8;
+  static constexpr uint32_t UCB_C_PERMILLE   = 150;   // exploration, in reward per-mille
+
+  static constexpr const char* FLASH_REGION = "flip_strategy";  // ext_map_addr() entry
+  static constexpr int      FLASH_SECTOR  = 0x1000;  // erase unit; the region must be aligned to it
+  static constexpr uint32_t FLASH_MAGIC   = 0x31425453u;  // "STB1"
+  static constexpr uint16_t FLASH_VERSION = 1;
+
+  struct Cell {
+    uint16_t n;
+    uint16_t reserved;
+    uint32_t rewardSum;  // per-mille
+  };
+
+  static Tilt tiltFor(int32_t rollCentideg);
+  static uint16_t rewardFor(bool completed, uint32_t ticks);
+
+  // Arm to try next. Untried arms go first, preferredArm before the other;
+  // after that the highest upper confidence bound wins.
+  int  select(uint8_t orient, Tilt tilt, int preferredArm) const;
+  void record(uint8_t orient, Tilt tilt, int arm, uint16_t rewardPermille);
+
+  const Cell& cell(uint8_t orient, Tilt tilt, int arm) const { return cells[orient][tilt][arm]; }
+  void reset();
+
+  // Both return false (and leave the table untouched on load) on flash
+  // errors, a missing or misaligned region, or a bad header/CRC. save()
+  // erases the sector first and blocks for the erase time.
+  bool load();
+  bool save();
+  // True once SAVE_EVERY outcomes have been recorded since the last save.
+  bool saveDue() const { return unsaved >= SAVE_EVERY; }
+  // Restarts the count towards saveDue(), e.g. after a snapshot was taken.
+  void markSaved() { unsaved = 0; }
+
+private:
+  Cell cells[ORIENTS][TILT_COUNT][ARMS] = {};
+  int  unsaved = 0;
+};
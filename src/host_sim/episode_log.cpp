@@ -0,0 +1,279 @@
+// src/host_sim/episode_log.cpp
+#include "episode_log.h"
+#include <cstring>
+
+const FcolColumnDesc FCOL_SCHEMA[FCOL_COLUMNS] = {
+  {"episode",   FCOL_U32},
+  {"tick",      FCOL_U32},
+  {"pitch_cd",  FCOL_I16},
+  {"yaw_cd",    FCOL_I16},
+  {"roll_cd",   FCOL_I16},
+  {"yaw_pwm",   FCOL_I8},
+  {"pitch_pwm", FCOL_I8},
+  {"drive_pwm", FCOL_I8},
+  {"phase",     FCOL_U8},
+  {"flags",     FCOL_U8},
+};
+
+static const char     FCOL_MAGIC[4]       = {'F', 'C', 'O', 'L'};
+static constexpr size_t FCOL_SUMMARY_BYTES = 36;
+
+int fcol_type_size(FcolType t) {
+  switch (t) {
+    case FCOL_U8:
+    case FCOL_I8:  return 1;
+    case FCOL_I16: return 2;
+    case FCOL_U32: return 4;
+  }
+  return 0;
+}
+
+static size_t align8(size_t n) { return (n + 7u) & ~size_t(7); }
+
+static float column_value(const uint8_t* p, FcolType t) {
+  switch (t) {
+    case FCOL_U8:  return (float)*p;
+    case FCOL_I8:  return (float)(int8_t)*p;
+    case FCOL_I16: { int16_t v; std::memcpy(&v, p, 2); return (float)v; }
+    case FCOL_U32: { uint32_t v; std::memcpy(&v, p, 4); return (float)v; }
+  }
+  return 0.0f;
+}
+
+// ---------------------------------------------------------------- writer
+
+bool EpisodeLogWriter::open(const char* path) {
+  close();
+  f = std::fopen(path, "wb");
+  if (!f) return false;
+  ok = true;
+  offset = 0;
+  totalRows = chunkRows = 0;
+  chunks.clear();
+  summaries.clear();
+  for (int c = 0; c < FCOL_COLUMNS; ++c) {
+    cols[c].assign((size_t)FCOL_CHUNK_ROWS * fcol_type_size(FCOL_SCHEMA[c].type), 0);
+  }
+  put(FCOL_MAGIC, 4);
+  put(&FCOL_VERSION, 4);
+  return ok;
+}
+
+void EpisodeLogWriter::put(const void* p, size_t n) {
+  if (ok && std::fwrite(p, 1, n, f) != n) ok = false;
+  offset += n;
+}
+
+void EpisodeLogWriter::beginEpisode(float pitch0, float yaw0, float roll, float payload) {
+  EpisodeSummary s{};
+  s.firstRow = totalRows;
+  s.pitch0   = pitch0;
+  s.yaw0     = yaw0;
+  s.roll     = roll;
+  s.payload  = payload;
+  summaries.push_back(s);
+}
+
+void EpisodeLogWriter::addTick(EpisodeTick t) {
+  if (!f || summaries.empty()) return;
+  t.episode = (uint32_t)summaries.size() - 1;
+
+  const void* field[FCOL_COLUMNS] = {&t.episode, &t.tick, &t.pitchCd, &t.yawCd, &t.rollCd,
+                                     &t.yawPwm, &t.pitchPwm, &t.drivePwm, &t.phase, &t.flags};
+  for (int c = 0; c < FCOL_COLUMNS; ++c) {
+    const int sz = fcol_type_size(FCOL_SCHEMA[c].type);
+    std::memcpy(cols[c].data() + (size_t)chunkRows * sz, field[c], (size_t)sz);
+  }
+  ++totalRows;
+  if (++chunkRows == FCOL_CHUNK_ROWS) flushChunk();
+}
+
+void EpisodeLogWriter::endEpisode(bool completed, float pitch, float yaw, uint8_t strategy) {
+  if (summaries.empty()) return;
+  EpisodeSummary& s = summaries.back();
+  s.ticks     = totalRows - s.firstRow;
+  s.pitch     = pitch;
+  s.yaw       = yaw;
+  s.completed = completed ? 1 : 0;
+  s.strategy  = strategy;
+}
+
+void EpisodeLogWriter::flushChunk() {
+  if (chunkRows == 0) return;
+  FcolChunk ch{};
+  ch.offset   = offset;
+  ch.rows     = chunkRows;
+  ch.firstRow = totalRows - chunkRows;
+
+  static const uint8_t ZERO[8] = {};
+  for (int c = 0; c < FCOL_COLUMNS; ++c) {
+    const FcolType t  = FCOL_SCHEMA[c].type;
+    const int      sz = fcol_type_size(t);
+    const uint8_t* p  = cols[c].data();
+    float lo = column_value(p, t), hi = lo;
+    for (uint32_t r = 1; r < chunkRows; ++r) {
+      float v = column_value(p + (size_t)r * sz, t);
+      if (v < lo) lo = v;
+      if (v > hi) hi = v;
+    }
+    ch.min[c] = lo;
+    ch.max[c] = hi;
+
+    const size_t n = (size_t)chunkRows * sz;
+    put(p, n);
+    put(ZERO, align8(n) - n);
+  }
+  ch.bytes = (uint32_t)(offset - ch.offset);
+  chunks.push_back(ch);
+  chunkRows = 0;
+}
+
+// Footer:
+//   u16 columns; per column: u8 type, u8 name_len, name
+//   u32 rows, u32 chunk_rows
+//   u32 chunks;  per chunk: u64 offset, u32 bytes, u32 rows, u32 first_row,
+//                           f32 min[columns], f32 max[columns]
+//   u32 episodes; per episode: EpisodeSummary (36 bytes)
+bool EpisodeLogWriter::close() {
+  if (!f) return ok;
+  flushChunk();
+
+  const uint64_t start = offset;
+  const uint16_t ncols = FCOL_COLUMNS;
+  put(&ncols, 2);
+  for (const FcolColumnDesc& d : FCOL_SCHEMA) {
+    const uint8_t len = (uint8_t)std::strlen(d.name);
+    put(&d.type, 1);
+    put(&len, 1);
+    put(d.name, len);
+  }
+  put(&totalRows, 4);
+  put(&FCOL_CHUNK_ROWS, 4);
+
+  const uint32_t nchunks = (uint32_t)chunks.size();
+  put(&nchunks, 4);
+  for (const FcolChunk& ch : chunks) {
+    put(&ch.offset, 8);
+    put(&ch.bytes, 4);
+    put(&ch.rows, 4);
+    put(&ch.firstRow, 4);
+    put(ch.min, sizeof(ch.min));
+    put(ch.max, sizeof(ch.max));
+  }
+
+  static_assert(sizeof(EpisodeSummary) == FCOL_SUMMARY_BYTES, "EpisodeSummary layout");
+  const uint32_t neps = (uint32_t)summaries.size();
+  put(&neps, 4);
+  if (neps) put(summaries.data(), summaries.size() * sizeof(EpisodeSummary));
+
+  const uint32_t footerBytes = (uint32_t)(offset - start);
+  put(&footerBytes, 4);
+  put(FCOL_MAGIC, 4);
+
+  if (std::fclose(f) != 0) ok = false;
+  f = nullptr;
+  return ok;
+}
+
+// ---------------------------------------------------------------- reader
+
+namespace {
+struct Cursor {
+  const uint8_t* p;
+  const uint8_t* end;
+  bool           ok = true;
+
+  void get(void* out, size_t n) {
+    if (!ok || (size_t)(end - p) < n) { ok = false; std::memset(out, 0, n); return; }
+    std::memcpy(out, p, n);
+    p += n;
+  }
+};
+}  // namespace
+
+bool EpisodeLogReader::open(const char* path) {
+  f = std::fopen(path, "rb");
+  if (!f) { err = "cannot open"; return false; }
+
+  char     magic[4];
+  uint32_t version = 0;
+  if (std::fread(magic, 1, 4, f) != 4 || std::memcmp(magic, FCOL_MAGIC, 4) != 0 ||
+      std::fread(&version, 4, 1, f) != 1) { err = "bad header"; return false; }
+  if (version != FCOL_VERSION) { err = "unsupported version"; return false; }
+
+  uint32_t footerBytes = 0;
+  if (std::fseek(f, -8, SEEK_END) != 0 || std::fread(&footerBytes, 4, 1, f) != 1 ||
+      std::fread(magic, 1, 4, f) != 4 || std::memcmp(magic, FCOL_MAGIC, 4) != 0) {
+    err = "bad trailer";
+    return false;
+  }
+  const long end = std::ftell(f);
+  if ((long)footerBytes + 16 > end) { err = "bad footer size"; return false; }
+
+  std::vector<uint8_t> foot(footerBytes);
+  if (std::fseek(f, end - 8 - (long)footerBytes, SEEK_SET) != 0 ||
+      std::fread(foot.data(), 1, foot.size(), f) != foot.size()) {
+    err = "short footer";
+    return false;
+  }
+
+  Cursor cur{foot.data(), foot.data() + foot.size()};
+  uint16_t ncols = 0;
+  cur.get(&ncols, 2);
+  if (ncols != FCOL_COLUMNS) { err = "schema mismatch"; return false; }
+  for (int c = 0; c < FCOL_COLUMNS; ++c) {
+    uint8_t type = 0, len = 0;
+    char    name[256];
+    cur.get(&type, 1);
+    cur.get(&len, 1);
+    cur.get(name, len);
+    if (type != FCOL_SCHEMA[c].type || std::strlen(FCOL_SCHEMA[c].name) != len ||
+        std::memcmp(name, FCOL_SCHEMA[c].name, len) != 0) {
+      err = "schema mismatch";
+      return false;
+    }
+  }
+  // Counts are checked against the bytes left before anything is sized
+  // from them, so a corrupt footer cannot request a huge allocation.
+  static constexpr size_t CHUNK_RECORD_BYTES = 8 + 4 + 4 + 4 + sizeof(FcolChunk::min) + sizeof(FcolChunk::max);
+  uint32_t chunkRows = 0, nchunks = 0, neps = 0;
+  cur.get(&totalRows, 4);
+  cur.get(&chunkRows, 4);
+  cur.get(&nchunks, 4);
+  if (cur.ok && (size_t)nchunks > (size_t)(cur.end - cur.p) / CHUNK_RECORD_BYTES) cur.ok = false;
+  chunks.resize(cur.ok ? nchunks : 0);
+  for (FcolChunk& ch : chunks) {
+    cur.get(&ch.offset, 8);
+    cur.get(&ch.bytes, 4);
+    cur.get(&ch.rows, 4);
+    cur.get(&ch.firstRow, 4);
+    cur.get(ch.min, sizeof(ch.min));
+    cur.get(ch.max, sizeof(ch.max));
+    if (ch.rows > chunkRows) cur.ok = false;
+  }
+  cur.get(&neps, 4);
+  const size_t left = (size_t)(cur.end - cur.p);
+  if (cur.ok && (left % sizeof(EpisodeSummary) != 0 || neps != left / sizeof(EpisodeSummary))) cur.ok = false;
+  summaries.resize(cur.ok ? neps : 0);
+  if (neps) cur.get(summaries.data(), summaries.size() * sizeof(EpisodeSummary));
+  if (!cur.ok) { err = "truncated footer"; return false; }
+  return true;
+}
+
+bool EpisodeLogReader::readChunk(size_t i) {
+  if (!f || i >= chunks.size()) return false;
+  const FcolChunk& ch = chunks[i];
+  size_t need = 0;
+  for (int c = 0; c < FCOL_COLUMNS; ++c) {
+    colOffset[c] = need;
+    need += align8((size_t)ch.rows * fcol_type_size(FCOL_SCHEMA[c].type));
+  }
+  if (need != ch.bytes) { err = "chunk size mismatch"; return false; }
+  buf.resize(need);
+  if (std::fseek(f, (long)ch.offset, SEEK_SET) != 0 ||
+      std::fread(buf.data(), 1, need, f) != need) {
+    err = "short chunk";
+    return false;
+  }
+  return true;
+}
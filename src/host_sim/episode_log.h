@@ -0,0 +1,137 @@
+#pragma once
+// Columnar episode log ("FCOL") for the host-sim tools.
+//
+// Ticks are written in chunks of up to FCOL_CHUNK_ROWS rows. Inside a chunk
+// each column is one contiguous little-endian array, padded to 8 bytes, so a
+// reader can map it straight onto a typed array. Only the open chunk is held
+// in memory while writing. The footer carries the schema, a chunk index with
+// per-column min/max (enough to draw an overview without touching the data)
+// and one summary row per episode, so a viewer can list failures and seek to
+// them directly.
+//
+//   "FCOL" u32 version
+//   chunk*                       column arrays, schema order
+//   footer                       see EpisodeLogWriter::close()
+//   u32 footer_bytes, "FCOL"
+//
+// A row is 19 bytes of column data in FcolColumn order: u32 episode,
+// u32 tick, i16 pitch/yaw/roll, i8 yaw/pitch/drive PWM, u8 phase, u8 flags.
+// A chunk of n rows holds n values of each column in turn, each array
+// padded to 8 bytes. EpisodeTick is the in-memory row, not this layout.
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t FCOL_VERSION    = 1;
+static constexpr uint32_t FCOL_CHUNK_ROWS = 4096;
+
+enum FcolType : uint8_t { FCOL_U8 = 1, FCOL_I8, FCOL_I16, FCOL_U32 };
+
+enum FcolColumn : uint8_t {
+  FCOL_EPISODE = 0,  // u32, episode index in file
+  FCOL_TICK,         // u32, tick within the episode
+  FCOL_PITCH,        // i16, centideg
+  FCOL_YAW,          // i16, centideg
+  FCOL_ROLL,         // i16, centideg
+  FCOL_YAW_PWM,      // i8
+  FCOL_PITCH_PWM,    // i8
+  FCOL_DRIVE_PWM,    // i8
+  FCOL_PHASE,        // u8, FlipController::Phase
+  FCOL_FLAGS,        // u8, FCOL_FLAG_*
+  FCOL_COLUMNS
+};
+
+static constexpr uint8_t FCOL_FLAG_BUSY = 1u << 0;
+
+struct FcolColumnDesc {
+  const char* name;
+  FcolType    type;
+};
+extern const FcolColumnDesc FCOL_SCHEMA[FCOL_COLUMNS];
+
+int fcol_type_size(FcolType t);
+
+struct EpisodeTick {
+  uint32_t episode;
+  uint32_t tick;
+  int16_t  pitchCd, yawCd, rollCd;
+  int8_t   yawPwm, pitchPwm, drivePwm;
+  uint8_t  phase;
+  uint8_t  flags;
+};
+
+// Footer summary of one episode; 36 bytes on disk.
+struct EpisodeSummary {
+  uint32_t firstRow;
+  uint32_t ticks;
+  float    pitch0, yaw0, roll, payload;
+  float    pitch, yaw;  // final pose
+  uint8_t  completed;
+  uint8_t  strategy;    // FlipController::Strategy chosen for the flip
+  uint16_t reserved;
+};
+
+struct FcolChunk {
+  uint64_t offset;
+  uint32_t bytes;
+  uint32_t rows;
+  uint32_t firstRow;
+  float    min[FCOL_COLUMNS];
+  float    max[FCOL_COLUMNS];
+};
+
+class EpisodeLogWriter {
+public:
+  ~EpisodeLogWriter() { close(); }
+
+  bool open(const char* path);
+  // Ticks added between begin and end belong to that episode.
+  void beginEpisode(float pitch0, float yaw0, float roll, float payload);
+  void addTick(EpisodeTick t);  // episode field is filled in here
+  void endEpisode(bool completed, float pitch, float yaw, uint8_t strategy);
+  // Flushes the open chunk and writes the footer; false on any I/O error.
+  bool close();
+
+  uint32_t rows() const { return totalRows; }
+  uint32_t episodes() const { return (uint32_t)summaries.size(); }
+
+private:
+  FILE*                       f = nullptr;
+  bool                        ok = true;
+  uint64_t                    offset = 0;
+  uint32_t                    totalRows = 0;
+  uint32_t                    chunkRows = 0;
+  std::vector<uint8_t>        cols[FCOL_COLUMNS];
+  std::vector<FcolChunk>      chunks;
+  std::vector<EpisodeSummary> summaries;
+
+  void put(const void* p, size_t n);
+  void flushChunk();
+};
+
+class EpisodeLogReader {
+public:
+  ~EpisodeLogReader() { if (f) std::fclose(f); }
+
+  // Reads header and footer only; false (with why() set) if malformed.
+  bool open(const char* path);
+  const char* why() const { return err.c_str(); }
+
+  uint32_t rows() const { return totalRows; }
+  const std::vector<FcolChunk>&      chunkIndex() const { return chunks; }
+  const std::vector<EpisodeSummary>& episodes() const { return summaries; }
+
+  // Loads one chunk; column(c) then points at its array.
+  bool readChunk(size_t i);
+  const void* column(int c) const { return buf.data() + colOffset[c]; }
+
+private:
+  FILE*                       f = nullptr;
+  std::string                 err;
+  uint32_t                    totalRows = 0;
+  std::vector<FcolChunk>      chunks;
+  std::vector<EpisodeSummary> summaries;
+  std::vector<uint8_t>        buf;
+  size_t                      colOffset[FCOL_COLUMNS] = {};
+};
@@ -0,0 +1,141 @@
+// src/host_sim/fcol_dump.cpp
+//
+// Headless triage for episode logs written by ./sim <mode> --record FILE.
+// Prints the file summary and the episodes that did not complete; with
+// --episode N, the ticks of one episode (only its chunks are read); with
+// --check, scans every chunk against the footer index and exits non-zero
+// on any mismatch.
+//
+// Usage: ./fcol_dump FILE [--episode N] [--check]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "episode_log.h"
+
+static constexpr int MAX_LISTED = 20;
+
+template <typename T>
+static T at(const EpisodeLogReader& r, int c, uint32_t row) {
+  return static_cast<const T*>(r.column(c))[row];
+}
+
+static void print_summary(const EpisodeLogReader& r) {
+  const auto& eps = r.episodes();
+  int failed = 0;
+  for (const EpisodeSummary& e : eps) failed += e.completed ? 0 : 1;
+  std::printf("[FCOL] %u ticks, %zu chunks, %zu episodes, %d incomplete\n",
+              r.rows(), r.chunkIndex().size(), eps.size(), failed);
+
+  int listed = 0;
+  for (size_t i = 0; i < eps.size() && listed < MAX_LISTED; ++i) {
+    const EpisodeSummary& e = eps[i];
+    if (e.completed) continue;
+    if (listed++ == 0) std::puts("  episode  pitch0   yaw0   roll payload  ticks  final pitch/yaw  strat");
+    std::printf("  %7zu %7.1f %6.1f %6.1f %7.2f %6u  %7.1f %7.1f  %5u\n", i, e.pitch0, e.yaw0,
+                e.roll, e.payload, e.ticks, e.pitch, e.yaw, e.strategy);
+  }
+  if (failed > listed) std::printf("  ... %d more\n", failed - listed);
+}
+
+static bool print_episode(EpisodeLogReader& r, size_t n) {
+  if (n >= r.episodes().size()) {
+    std::fprintf(stderr, "episode %zu out of range\n", n);
+    return false;
+  }
+  const EpisodeSummary& e = r.episodes()[n];
+  std::printf("[FCOL] episode %zu: pitch0=%.1f yaw0=%.1f roll=%.1f payload=%.2f ticks=%u %s\n", n,
+              e.pitch0, e.yaw0, e.roll, e.payload, e.ticks, e.completed ? "completed" : "INCOMPLETE");
+  std::puts("   tick   pitch     yaw    roll  yawP pitP drvP phase busy");
+
+  const uint32_t first = e.firstRow, last = e.firstRow + e.ticks;
+  const auto& idx = r.chunkIndex();
+  for (size_t c = 0; c < idx.size(); ++c) {
+    const FcolChunk& ch = idx[c];
+    if (ch.firstRow + ch.rows <= first || ch.firstRow >= last) continue;
+    if (!r.readChunk(c)) { std::fprintf(stderr, "chunk %zu: %s\n", c, r.why()); return false; }
+    for (uint32_t row = 0; row < ch.rows; ++row) {
+      const uint32_t g = ch.firstRow + row;
+      if (g < first || g >= last) continue;
+      std::printf("  %5u %7.2f %7.2f %7.2f %5d %4d %4d %5u %4s\n", at<uint32_t>(r, FCOL_TICK, row),
+                  at<int16_t>(r, FCOL_PITCH, row) / 100.0, at<int16_t>(r, FCOL_YAW, row) / 100.0,
+                  at<int16_t>(r, FCOL_ROLL, row) / 100.0, at<int8_t>(r, FCOL_YAW_PWM, row),
+                  at<int8_t>(r, FCOL_PITCH_PWM, row), at<int8_t>(r, FCOL_DRIVE_PWM, row),
+                  at<uint8_t>(r, FCOL_PHASE, row),
+                  (at<uint8_t>(r, FCOL_FLAGS, row) & FCOL_FLAG_BUSY) ? "yes" : "");
+    }
+  }
+  return true;
+}
+
+static float value_at(const EpisodeLogReader& r, int c, uint32_t row) {
+  switch (FCOL_SCHEMA[c].type) {
+    case FCOL_U8:  return at<uint8_t>(r, c, row);
+    case FCOL_I8:  return at<int8_t>(r, c, row);
+    case FCOL_I16: return at<int16_t>(r, c, row);
+    case FCOL_U32: return (float)at<uint32_t>(r, c, row);
+  }
+  return 0.0f;
+}
+
+static bool check(EpisodeLogReader& r) {
+  const auto& idx = r.chunkIndex();
+  const auto& eps = r.episodes();
+  uint32_t expectRow = 0;
+  long     bad = 0;
+  for (size_t c = 0; c < idx.size(); ++c) {
+    const FcolChunk& ch = idx[c];
+    if (ch.firstRow != expectRow) { std::printf("chunk %zu: first_row %u, expected %u\n", c, ch.firstRow, expectRow); ++bad; }
+    expectRow = ch.firstRow + ch.rows;
+    if (!r.readChunk(c)) { std::printf("chunk %zu: %s\n", c, r.why()); ++bad; continue; }
+
+    for (int col = 0; col < FCOL_COLUMNS; ++col) {
+      float lo = value_at(r, col, 0), hi = lo;
+      for (uint32_t row = 1; row < ch.rows; ++row) {
+        float v = value_at(r, col, row);
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+      }
+      if (lo != ch.min[col] || hi != ch.max[col]) {
+        std::printf("chunk %zu: %s stats differ from data\n", c, FCOL_SCHEMA[col].name);
+        ++bad;
+      }
+    }
+    for (uint32_t row = 0; row < ch.rows; ++row) {
+      const uint32_t e = at<uint32_t>(r, FCOL_EPISODE, row), g = ch.firstRow + row;
+      if (e >= eps.size() || g < eps[e].firstRow || g >= eps[e].firstRow + eps[e].ticks ||
+          at<uint32_t>(r, FCOL_TICK, row) != g - eps[e].firstRow + 1) {
+        if (bad++ < 10) std::printf("row %u: episode/tick inconsistent with footer\n", g);
+      }
+    }
+  }
+  if (expectRow != r.rows()) { std::printf("chunks hold %u rows, footer says %u\n", expectRow, r.rows()); ++bad; }
+  std::printf("[FCOL] check: %s (%ld problems)\n", bad ? "FAIL" : "PASS", bad);
+  return bad == 0;
+}
+
+int main(int argc, char** argv) {
+  const char* path    = nullptr;
+  long        episode = -1;
+  bool        doCheck = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--episode") && i + 1 < argc) episode = std::atol(argv[++i]);
+    else if (!std::strcmp(argv[i], "--check"))             doCheck = true;
+    else if (!path && argv[i][0] != '-')                    path = argv[i];
+    else { path = nullptr; break; }
+  }
+  if (!path) {
+    std::fprintf(stderr, "usage: %s FILE [--episode N] [--check]\n", argv[0]);
+    return 2;
+  }
+
+  EpisodeLogReader r;
+  if (!r.open(path)) {
+    std::fprintf(stderr, "%s: %s\n", path, r.why());
+    return 1;
+  }
+  print_summary(r);
+  if (episode >= 0 && !print_episode(r, (size_t)episode)) return 1;
+  if (doCheck && !check(r)) return 1;
+  return 0;
+}
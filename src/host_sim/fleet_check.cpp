@@ -0,0 +1,145 @@
+// src/host_sim/fleet_check.cpp
+//
+// Protocol round trip against a running fleet_server (make fleet-check):
+// flips one robot through the socket while another stays idle, and checks
+// response order, per-robot clocks, the error statuses, the per-batch
+// tick budget and that teleop on an idle robot heats its power budget.
+//
+// Usage: ./fleet_check SOCKET [robots]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "fleet_server.h"
+
+static int s_fails = 0;
+
+static void expect(bool ok, const char* what) {
+  if (ok) return;
+  std::printf("[FLEET] check failed: %s\n", what);
+  ++s_fails;
+}
+
+static bool io_full(int fd, void* buf, size_t n, bool wr) {
+  auto* p = static_cast<uint8_t*>(buf);
+  while (n) {
+    ssize_t k = wr ? ::write(fd, p, n) : ::read(fd, p, n);
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) return false;
+    p += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+// The server may still be starting; retry for up to two seconds.
+static int connect_to(const char* path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  for (int attempt = 0; attempt < 200; ++attempt) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+    ::close(fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return -1;
+}
+
+static std::vector<FleetResp> batch(int fd, std::vector<FleetReq> req) {
+  FleetHdr hdr{FLEET_MAGIC, (uint32_t)req.size()};
+  std::vector<FleetResp> resp;
+  if (!io_full(fd, &hdr, sizeof(hdr), true) ||
+      !io_full(fd, req.data(), req.size() * sizeof(FleetReq), true) ||
+      !io_full(fd, &hdr, sizeof(hdr), false)) {
+    expect(false, "socket I/O");
+    return resp;
+  }
+  expect(hdr.magic == FLEET_MAGIC && hdr.count == req.size(), "response header");
+  resp.resize(hdr.count);
+  if (hdr.count && !io_full(fd, resp.data(), resp.size() * sizeof(FleetResp), false)) {
+    expect(false, "socket I/O");
+    resp.clear();
+  }
+  return resp;
+}
+
+// FLEET_OP_TELEOP's arg0.
+static int32_t pwm3(int8_t yaw, int8_t pitch, int8_t drive) {
+  return (int32_t)((uint32_t)(uint8_t)yaw | (uint32_t)(uint8_t)pitch << 8 | (uint32_t)(uint8_t)drive << 16);
+}
+
+static FleetReq req(uint16_t robot, FleetOp op, int32_t a0 = 0, int32_t a1 = 0) {
+  FleetReq q{};
+  q.robot = robot;
+  q.op    = op;
+  q.arg0  = a0;
+  q.arg1  = a1;
+  return q;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s SOCKET [robots]\n", argv[0]);
+    return 2;
+  }
+  const uint16_t robots = (uint16_t)(argc > 2 ? std::atoi(argv[2]) : 4);
+  int fd = connect_to(argv[1]);
+  if (fd < 0) { std::perror(argv[1]); return 2; }
+
+  // Robot 0 flips from its left side; robot 1 only reports.
+  auto r = batch(fd, {req(0, FLEET_OP_SET_POSE, -9000, 0), req(0, FLEET_OP_TRIGGER), req(1, FLEET_OP_STATE),
+                      req(robots, FLEET_OP_STATE), req(0, (FleetOp)0xEE)});
+  if (r.size() == 5) {
+    expect(r[0].robot == 0 && r[0].status == FLEET_OK && r[0].pitch_cd == -9000, "set pose");
+    expect(r[2].robot == 1 && r[2].status == FLEET_OK && r[2].now_ms == 0, "idle robot state");
+    expect(r[3].robot == robots && r[3].status == FLEET_BAD_ROBOT, "unknown robot rejected");
+    expect(r[4].status == FLEET_BAD_OP, "unknown op rejected");
+  }
+
+  r = batch(fd, {req(0, FLEET_OP_STEP, 300), req(1, FLEET_OP_STATE)});
+  if (r.size() == 2) {
+    expect(r[0].status == FLEET_OK && !r[0].busy, "flip finished within 300 ticks");
+    expect(std::abs(r[0].pitch_cd) <= 1200, "robot level after the flip");
+    expect(r[0].now_ms == 3000, "stepped robot clock");
+    expect(r[1].now_ms == 0, "other robot clock untouched");
+  }
+
+  // Two STEPs fill robot 0's budget; the third is rejected unrun, and the
+  // budget is per robot and per batch.
+  r = batch(fd, {req(0, FLEET_OP_STEP, FLEET_MAX_STEP_TICKS), req(0, FLEET_OP_STEP, FLEET_MAX_STEP_TICKS),
+                 req(1, FLEET_OP_STEP, 10), req(0, FLEET_OP_STATE)});
+  if (r.size() == 4) {
+    expect(r[0].status == FLEET_OK, "first STEP within budget");
+    expect(r[1].status == FLEET_OVER_BUDGET, "STEP past the batch budget rejected");
+    expect(r[2].status == FLEET_OK && r[2].now_ms == 100, "budget is per robot");
+    expect(r[3].now_ms == 3000 + FLEET_MAX_BATCH_TICKS * 10, "rejected STEP did not run");
+  }
+  r = batch(fd, {req(0, FLEET_OP_STEP, 1)});
+  if (r.size() == 1) expect(r[0].status == FLEET_OK, "budget resets with the next batch");
+
+  // Teleop on idle robot 1: its controller sends only zeros, yet the pitch
+  // joint it does not command heats the budget, and cools once teleop stops.
+  r = batch(fd, {req(1, FLEET_OP_TELEOP, pwm3(0, 100, 0)), req(1, FLEET_OP_STEP, 100)});
+  uint8_t heat = 0;
+  if (r.size() == 2) {
+    heat = r[1].heat_pct;
+    expect(r[1].status == FLEET_OK && !r[1].busy, "teleop steps an idle robot");
+    expect(heat >= 25, "teleop heats the idle robot's budget");
+  }
+  r = batch(fd, {req(1, FLEET_OP_TELEOP, 0), req(1, FLEET_OP_STEP, 100)});
+  if (r.size() == 2) expect(r[1].heat_pct < heat, "budget cools once teleop stops");
+
+  ::close(fd);
+  std::printf("[FLEET] check: %s\n", s_fails ? "FAIL" : "PASS");
+  return s_fails ? 1 : 0;
+}
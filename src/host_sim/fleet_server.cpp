@@ -0,0 +1,322 @@
+// src/host_sim/fleet_server.cpp
+//
+// Hosts N independent simulated robots (FlipController + mocked platform),
+// one pinned worker thread each, behind a Unix stream socket. Each worker
+// thread runs its own SimRobot (mock_all.h), so workers share nothing; each
+// has its own virtual clock.
+// A batch is fanned out to the robots it names and answered once every
+// robot has finished its part. One robot runs at most FLEET_MAX_BATCH_TICKS
+// per batch (STEPs past that are rejected), so one batch has bounded
+// latency. Protocol: fleet_server.h.
+//
+// Usage: ./fleet_server [socket_path] [robots] [--once]
+//   --once: exit after the first client disconnects (make fleet-check)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sim_episode.h"
+#include "fleet_server.h"
+
+struct Robot {
+  std::thread             th;
+  std::mutex              m;
+  std::condition_variable cv;
+  std::vector<uint32_t>   jobs;  // request indices of the current batch, in order
+  int32_t                 batchTicks = 0;  // STEP ticks accepted in the current batch
+  bool hasWork = false;
+  bool quit    = false;
+};
+
+// The batch in flight; only one at a time.
+struct Batch {
+  const FleetReq*         req  = nullptr;
+  FleetResp*              resp = nullptr;
+  std::mutex              m;
+  std::condition_variable cv;
+  int                     pending = 0;
+};
+
+static Batch s_batch;
+
+static thread_local motors_action_t t_lastCmd{};
+static thread_local motors_action_t t_teleop{};
+static void robot_motor_hook(const motors_action_t* a) { t_lastCmd = *a; }
+
+static uint8_t hottest_pct(const PowerBudget& p) {
+  int32_t pm = 0;
+  for (int m = 0; m < PowerBudget::M_COUNT; ++m) {
+    const int32_t h = p.heatPermille((PowerBudget::Motor)m);
+    if (h > pm) pm = h;
+  }
+  return (uint8_t)(pm / 10 > 255 ? 255 : pm / 10);
+}
+
+static int32_t step_ticks(const FleetReq& q) {
+  int32_t n = q.arg0;
+  if (n < 1) n = 1;
+  if (n > FLEET_MAX_STEP_TICKS) n = FLEET_MAX_STEP_TICKS;
+  return n;
+}
+
+static FleetResp serve(FlipController& fc, const FleetReq& q) {
+  FleetResp out{};
+  out.robot  = q.robot;
+  out.status = FLEET_OK;
+
+  switch (q.op) {
+    case FLEET_OP_STATE:
+      break;
+    case FLEET_OP_STEP: {
+      int32_t n = step_ticks(q);
+      const bool teleop = t_teleop.yaw || t_teleop.pitch || t_teleop.drive;
+      while (n--) {
+        if (teleop) set_motors(&t_teleop);
+        fc.loop();
+        g_sim_now_ms += 10;
+      }
+      break;
+    }
+    case FLEET_OP_TRIGGER:
+      fc.triggerRecovery();
+      break;
+    case FLEET_OP_ABORT:
+      fc.abortRecovery();
+      break;
+    case FLEET_OP_SET_POSE:
+      g_imu.pitch_deg      = (float)q.arg0 / 100.0f;
+      g_imu.yaw_deg        = (float)q.arg1 / 100.0f;
+      g_imu.pitch_rate_dps = 0.0f;
+      break;
+    case FLEET_OP_SET_PAYLOAD:
+      g_imu.payload = (q.arg0 > 100) ? (float)q.arg0 / 1000.0f : 0.1f;
+      break;
+    case FLEET_OP_TELEOP:
+      t_teleop       = motors_action_t{};
+      t_teleop.yaw   = (int8_t)(q.arg0 & 0xFF);
+      t_teleop.pitch = (int8_t)((q.arg0 >> 8) & 0xFF);
+      t_teleop.drive = (int8_t)((q.arg0 >> 16) & 0xFF);
+      // Teleop drives the motors itself; the flip budget only hears of it.
+      fc.observeMotorCmd(t_teleop.yaw, t_teleop.pitch, t_teleop.drive);
+      break;
+    default:
+      out.status = FLEET_BAD_OP;
+      break;
+  }
+
+  out.busy      = fc.busy() ? 1 : 0;
+  out.pitch_cd  = (int32_t)std::lround(g_imu.pitch_deg * 100.0f);
+  out.yaw_cd    = (int32_t)std::lround(g_imu.yaw_deg * 100.0f);
+  out.now_ms    = g_sim_now_ms;
+  out.yaw_pwm   = t_lastCmd.yaw;
+  out.pitch_pwm = t_lastCmd.pitch;
+  out.drive_pwm = t_lastCmd.drive;
+  out.heat_pct  = hottest_pct(fc.powerBudget());
+  return out;
+}
+
+static void robot_main(Robot* r) {
+  sim_headless_init(robot_motor_hook);
+
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+
+  for (;;) {
+    std::unique_lock<std::mutex> lk(r->m);
+    r->cv.wait(lk, [r] { return r->hasWork || r->quit; });
+    if (r->quit) return;
+    lk.unlock();
+
+    for (uint32_t i : r->jobs) s_batch.resp[i] = serve(fc, s_batch.req[i]);
+
+    lk.lock();
+    r->jobs.clear();
+    r->hasWork = false;
+    lk.unlock();
+
+    std::lock_guard<std::mutex> g(s_batch.m);
+    if (--s_batch.pending == 0) s_batch.cv.notify_one();
+  }
+}
+
+static bool read_full(int fd, void* buf, size_t n) {
+  auto* p = static_cast<uint8_t*>(buf);
+  while (n) {
+    ssize_t k = ::read(fd, p, n);
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) return false;
+    p += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+static bool write_full(int fd, const void* buf, size_t n) {
+  auto* p = static_cast<const uint8_t*>(buf);
+  while (n) {
+    ssize_t k = ::write(fd, p, n);
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) return false;
+    p += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+static void serve_client(int fd, std::vector<std::unique_ptr<Robot>>& robots) {
+  std::vector<FleetReq>  req;
+  std::vector<FleetResp> resp;
+  long   batches = 0;
+  double worstUs = 0.0, totalUs = 0.0;
+
+  FleetHdr hdr;
+  while (read_full(fd, &hdr, sizeof(hdr))) {
+    if (hdr.magic != FLEET_MAGIC || hdr.count > FLEET_MAX_BATCH) {
+      std::fprintf(stderr, "[FLEET] bad header (magic=%08x count=%u), dropping client\n",
+                   hdr.magic, hdr.count);
+      break;
+    }
+    req.resize(hdr.count);
+    resp.assign(hdr.count, FleetResp{});
+    if (hdr.count && !read_full(fd, req.data(), hdr.count * sizeof(FleetReq))) break;
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<Robot*> touched;
+    for (uint32_t i = 0; i < hdr.count; ++i) {
+      if (req[i].robot >= robots.size()) {
+        resp[i].robot  = req[i].robot;
+        resp[i].status = FLEET_BAD_ROBOT;
+        continue;
+      }
+      Robot* r = robots[req[i].robot].get();
+      if (req[i].op == FLEET_OP_STEP) {
+        const int32_t n = step_ticks(req[i]);
+        if (r->batchTicks + n > FLEET_MAX_BATCH_TICKS) {
+          resp[i].robot  = req[i].robot;
+          resp[i].status = FLEET_OVER_BUDGET;
+          continue;
+        }
+        r->batchTicks += n;
+      }
+      if (r->jobs.empty()) touched.push_back(r);
+      r->jobs.push_back(i);
+    }
+
+    s_batch.req     = req.data();
+    s_batch.resp    = resp.data();
+    s_batch.pending = (int)touched.size();
+    for (Robot* r : touched) {
+      std::lock_guard<std::mutex> g(r->m);
+      r->hasWork = true;
+      r->cv.notify_one();
+    }
+    {
+      std::unique_lock<std::mutex> lk(s_batch.m);
+      s_batch.cv.wait(lk, [] { return s_batch.pending == 0; });
+    }
+    for (Robot* r : touched) r->batchTicks = 0;
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (us > worstUs) worstUs = us;
+    totalUs += us;
+    ++batches;
+
+    FleetHdr out{FLEET_MAGIC, hdr.count};
+    if (!write_full(fd, &out, sizeof(out)) ||
+        (hdr.count && !write_full(fd, resp.data(), hdr.count * sizeof(FleetResp)))) break;
+  }
+
+  std::printf("[FLEET] client done: batches=%ld mean=%.1f us worst=%.1f us\n",
+              batches, batches ? totalUs / batches : 0.0, worstUs);
+  std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  const char* path = (argc > 1) ? argv[1] : "/tmp/flip_fleet.sock";
+  long nRobots     = (argc > 2) ? std::atol(argv[2]) : 64;
+  const bool once  = argc > 3 && !std::strcmp(argv[3], "--once");
+  if (nRobots < 1 || nRobots > 65535) {
+    std::fprintf(stderr, "robots must be 1..65535\n");
+    return 2;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) { std::perror("socket"); return 1; }
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  // Replace a stale socket from an earlier run, never any other file.
+  struct stat st;
+  if (::lstat(path, &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      std::fprintf(stderr, "%s: exists and is not a socket\n", path);
+      return 1;
+    }
+    ::unlink(path);
+  }
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 4) < 0) {
+    std::perror(path);
+    return 1;
+  }
+
+  const unsigned ncpu = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+  std::vector<std::unique_ptr<Robot>> robots;
+  long unpinned = 0;
+  int  pinErr   = 0;
+  for (long i = 0; i < nRobots; ++i) {
+    robots.emplace_back(new Robot);
+    robots.back()->th = std::thread(robot_main, robots.back().get());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(i % ncpu), &set);
+    if (int e = pthread_setaffinity_np(robots.back()->th.native_handle(), sizeof(set), &set)) {
+      ++unpinned;
+      pinErr = e;
+    }
+  }
+  std::printf("[FLEET] %ld robots on %u cpus, listening on %s\n", nRobots, ncpu, path);
+  if (unpinned) {
+    std::printf("[FLEET] warning: %ld robot threads left unpinned (%s); latency is not isolated\n",
+                unpinned, std::strerror(pinErr));
+  }
+  std::fflush(stdout);
+
+  for (;;) {
+    int c = ::accept(fd, nullptr, nullptr);
+    if (c < 0) {
+      if (errno == EINTR) continue;
+      std::perror("accept");
+      break;
+    }
+    serve_client(c, robots);
+    ::close(c);
+    if (once) break;
+  }
+
+  for (auto& r : robots) {
+    { std::lock_guard<std::mutex> g(r->m); r->quit = true; }
+    r->cv.notify_one();
+    r->th.join();
+  }
+  ::close(fd);
+  ::unlink(path);
+  return 0;
+}
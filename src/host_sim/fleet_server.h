@@ -0,0 +1,68 @@
+#pragma once
+// Wire protocol for fleet_server: many simulated robots behind one Unix
+// stream socket. Everything is little-endian and packed.
+//
+//   request batch : FleetHdr + count * FleetReq
+//   response batch: FleetHdr + count * FleetResp   (same order as requests)
+//
+// Python: hdr '<II', req '<HBBii', resp '<HBBiiIbbbB'.
+#include <stdint.h>
+
+static constexpr uint32_t FLEET_MAGIC          = 0x31544C46u;  // "FLT1"
+static constexpr uint32_t FLEET_MAX_BATCH      = 4096;
+static constexpr int32_t  FLEET_MAX_STEP_TICKS = 1000;  // bounds one request's work
+// Bounds one robot's work per batch, and so the batch's latency: a STEP that
+// would take a robot past this many ticks in one batch is rejected unrun.
+static constexpr int32_t  FLEET_MAX_BATCH_TICKS = 1000;
+
+enum FleetOp : uint8_t {
+  FLEET_OP_STATE = 0,    // report only
+  FLEET_OP_STEP,         // arg0 = ticks (10 ms each), clamped to 1..FLEET_MAX_STEP_TICKS
+  FLEET_OP_TRIGGER,      // triggerRecovery()
+  FLEET_OP_ABORT,        // abortRecovery()
+  FLEET_OP_SET_POSE,     // arg0 = pitch, arg1 = yaw, centideg
+  FLEET_OP_SET_PAYLOAD,  // arg0 = payload inertia in 1/1000
+  // Operator command: arg0 bytes 0..2 = yaw, pitch, drive PWM (int8). Sent
+  // to the motors before every STEP tick until changed; 0 stops it. Each
+  // change is reported once to the robot's power budget.
+  FLEET_OP_TELEOP,
+};
+
+enum FleetStatus : uint8_t {
+  FLEET_OK = 0,
+  FLEET_BAD_ROBOT,
+  FLEET_BAD_OP,
+  FLEET_OVER_BUDGET,  // STEP past FLEET_MAX_BATCH_TICKS for this robot
+};
+
+#pragma pack(push, 1)
+struct FleetHdr {
+  uint32_t magic;
+  uint32_t count;
+};
+
+struct FleetReq {
+  uint16_t robot;
+  uint8_t  op;
+  uint8_t  flags;  // reserved, 0
+  int32_t  arg0;
+  int32_t  arg1;
+};
+
+struct FleetResp {
+  uint16_t robot;
+  uint8_t  status;
+  uint8_t  busy;      // flip in progress
+  int32_t  pitch_cd;
+  int32_t  yaw_cd;
+  uint32_t now_ms;    // robot's virtual clock
+  int8_t   yaw_pwm;   // last command
+  int8_t   pitch_pwm;
+  int8_t   drive_pwm;
+  uint8_t  heat_pct;  // hottest flip motor, % of its I2t trip limit (max 255)
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FleetHdr)  == 8,  "FleetHdr layout");
+static_assert(sizeof(FleetReq)  == 12, "FleetReq layout");
+static_assert(sizeof(FleetResp) == 20, "FleetResp layout");
@@ -0,0 +1,221 @@
+// src/host_sim/flip_bench.cpp
+//
+// Scenario regression suite for FlipController. Each scenario sets an
+// initial pose, payload and disturbances, runs the controller headless
+// (re-triggering while it stops short of level, as an operator would) and
+// checks its pass criteria. The metrics are then compared with the
+// scenario's budgets:
+//   ticks to level, peak joint PWM, energy proxy (sum |PWM| over all motors),
+//   host ns per controller tick.
+// Every scenario must end level with each motor inside its own PWM limit
+// (FlipController::MAX_PWM_YAW/PITCH/DRIVE).
+// A metric more than --tolerance percent over its budget is a regression.
+// Each build (FLIP_FIXED_POINT=0/1) has its own budgets. The ns/tick budgets
+// are about 2x what the reference host measures at -O2 (110-140 float,
+// 100-130 fixed).
+//
+// Usage: ./flip_bench [--tolerance PCT] [--json FILE] [--no-timing]
+//   --json appends one line, a JSON object for this build, to FILE.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include "sim_episode.h"
+
+static constexpr float LEVEL_EPS_DEG = 12.0f;
+static constexpr int   MAX_ATTEMPTS  = 3;
+
+static const char* const BUILD_NAME = FLIP_FIXED_POINT ? "fixed" : "float";
+
+struct Kick {
+  int   tick   = -1;    // -1 terminates the list
+  float dPitch = 0.0f;  // deg added to the pose
+  float dYaw   = 0.0f;
+};
+
+struct Budget {
+  int    ticksToLevel;
+  int    peakPwm;
+  long   energy;
+  double nsPerTick;
+};
+
+struct Scenario {
+  const char* name;
+  float  pitch0, yaw0;
+  float  roll0;       // terrain cross-slope, deg (g_imu.roll_deg)
+  float  payload;
+  float  noiseDeg;    // uniform IMU noise per tick, +-deg
+  bool   concurrent;  // concurrent side-recovery phases
+  Kick   kicks[4];
+  int    maxTicks;    // pass: level within this many ticks
+  Budget budget[2];   // [FLIP_FIXED_POINT]
+};
+
+static const Scenario SCENARIOS[] = {
+  // name                 pitch0  yaw0  roll0 payload noise  conc  kicks                   max   float {ticks pwm energy ns}  fixed {ticks pwm energy ns}
+  {"left_side",           -90.0f,  0.0f,  0.0f, 1.0f, 0.0f, true,  {},                      500, {{  5, 90,  210, 300.0}, {  5, 90,  210, 250.0}}},
+  {"right_side",           90.0f,  0.0f,  0.0f, 1.0f, 0.0f, true,  {},                      500, {{  5, 90,  210, 300.0}, {  5, 90,  210, 250.0}}},
+  {"left_side_sequential",-90.0f,  0.0f,  0.0f, 1.0f, 0.0f, false, {},                      500, {{  8, 90,  210, 300.0}, {  8, 90,  210, 250.0}}},
+  {"upside_down",         180.0f,  0.0f,  0.0f, 1.0f, 0.0f, true,  {},                     1000, {{ 81, 90,  285, 250.0}, { 81, 90,  285, 200.0}}},
+  {"upside_down_tilted",  180.0f,  0.0f,-30.0f, 1.0f, 0.0f, true,  {},                     1000, {{120, 90, 2339, 250.0}, {120, 90, 2339, 200.0}}},
+  {"left_side_heavy",     -90.0f,  0.0f,  0.0f, 2.0f, 0.0f, true,  {},                      500, {{ 13, 90,  347, 300.0}, { 13, 90,  347, 250.0}}},
+  {"upside_down_heavy",   180.0f,  0.0f,  0.0f, 2.0f, 0.0f, true,  {},                     1500, {{123, 90, 2617, 250.0}, {123, 90, 2617, 200.0}}},
+  {"left_side_kicked",    -90.0f,  0.0f,  0.0f, 1.0f, 0.0f, true,  {{2, 25.0f, -10.0f}},    500, {{  6, 90,  242, 300.0}, {  6, 90,  242, 250.0}}},
+  {"upside_down_noisy",   170.0f,  0.0f,  0.0f, 1.0f, 2.0f, true,  {},                     1500, {{ 70, 90, 1174, 250.0}, { 70, 90, 1174, 200.0}}},
+};
+
+struct Result {
+  bool   passed;
+  bool   level;
+  int    ticksToLevel;
+  int    attempts;
+  int    peakPwm;     // joints, for the budget
+  int    peakYaw, peakPitch, peakDrive;
+  long   energy;
+  double nsPerTick;
+};
+
+// Kicks and noise for the scenario in flight; offset carries the tick count
+// across re-triggered attempts.
+struct Disturbance {
+  const Scenario* sc;
+  int             offset;
+  uint32_t        rng;
+};
+
+static void disturb(int tick, void* ctx) {
+  auto* d = static_cast<Disturbance*>(ctx);
+  const Scenario& sc = *d->sc;
+  for (const Kick& k : sc.kicks) {
+    if (k.tick < 0) break;
+    if (k.tick == d->offset + tick) {
+      g_imu.pitch_deg = sim_wrap_deg(g_imu.pitch_deg + k.dPitch);
+      g_imu.yaw_deg   = sim_wrap_deg(g_imu.yaw_deg + k.dYaw);
+    }
+  }
+  if (sc.noiseDeg > 0.0f) {
+    d->rng = d->rng * 1664525u + 1013904223u;
+    float u = (float)(d->rng >> 8) / 8388608.0f - 1.0f;
+    g_imu.pitch_deg = sim_wrap_deg(g_imu.pitch_deg + u * sc.noiseDeg);
+  }
+}
+
+static Result run_scenario(const Scenario& sc) {
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+  fc.setConcurrentPhases(sc.concurrent);
+
+  g_imu = SimIMU{};
+  g_imu.payload  = sc.payload;
+  g_imu.roll_deg = sc.roll0;
+
+  Result      r{};
+  Disturbance d{&sc, 0, 0xC0FFEEu};
+  float pitch = sc.pitch0, yaw = sc.yaw0;
+  while (d.offset < sc.maxTicks && r.attempts < MAX_ATTEMPTS) {
+    SimEpisode ep = sim_run_flip(fc, pitch, yaw, sc.maxTicks - d.offset, disturb, &d);
+    ++r.attempts;
+    d.offset += ep.ticks;
+    r.energy += ep.jointPwmSum + ep.drivePwmSum;
+    if (ep.peakJointPwm > r.peakPwm)   r.peakPwm   = ep.peakJointPwm;
+    if (ep.peakYawPwm   > r.peakYaw)   r.peakYaw   = ep.peakYawPwm;
+    if (ep.peakPitchPwm > r.peakPitch) r.peakPitch = ep.peakPitchPwm;
+    if (ep.peakDrivePwm > r.peakDrive) r.peakDrive = ep.peakDrivePwm;
+    if (!ep.completed) break;
+    if (std::fabs(g_imu.pitch_deg) <= LEVEL_EPS_DEG) { r.level = true; break; }
+    // Short of level: trigger again from where the robot stopped.
+    pitch = g_imu.pitch_deg;
+    yaw   = g_imu.yaw_deg;
+  }
+
+  r.ticksToLevel = d.offset;
+  r.passed       = r.level &&
+                   r.peakYaw   <= FlipController::MAX_PWM_YAW &&
+                   r.peakPitch <= FlipController::MAX_PWM_PITCH &&
+                   r.peakDrive <= FlipController::MAX_PWM_DRIVE;
+  return r;
+}
+
+// Host cost: repeat the scenario until ~20 ms of work has been timed.
+static double time_scenario(const Scenario& sc, int ticksPerRun) {
+  using clk = std::chrono::steady_clock;
+  long runs = 0;
+  auto t0 = clk::now();
+  double elapsed = 0.0;
+  do {
+    run_scenario(sc);
+    ++runs;
+    elapsed = std::chrono::duration<double, std::nano>(clk::now() - t0).count();
+  } while (elapsed < 20e6);
+  return elapsed / ((double)runs * (ticksPerRun > 0 ? ticksPerRun : 1));
+}
+
+static bool over(double value, double budget, double tolPct) {
+  return value > budget * (1.0 + tolPct / 100.0);
+}
+
+int main(int argc, char** argv) {
+  double      tolPct   = 10.0;
+  const char* jsonPath = nullptr;
+  bool        timing   = true;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc) tolPct = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    else if (!std::strcmp(argv[i], "--no-timing"))            timing = false;
+    else { std::fprintf(stderr, "usage: %s [--tolerance PCT] [--json FILE] [--no-timing]\n", argv[0]); return 2; }
+  }
+
+  sim_headless_init();
+
+  FILE* json = jsonPath ? std::fopen(jsonPath, "a") : nullptr;
+  if (jsonPath && !json) { std::perror(jsonPath); return 2; }
+  if (json) std::fprintf(json, "{\"build\": \"%s\", \"tolerance_pct\": %.1f, \"scenarios\": [", BUILD_NAME, tolPct);
+
+  std::printf("[BENCH] %s build\n", BUILD_NAME);
+  std::printf("%-22s %4s %6s %4s %5s %7s %8s  %s\n",
+              "scenario", "pass", "ticks", "try", "peak", "energy", "ns/tick", "budget");
+  int failures = 0;
+  bool first = true;
+  for (const Scenario& sc : SCENARIOS) {
+    Result r = run_scenario(sc);
+    r.nsPerTick = timing ? time_scenario(sc, r.ticksToLevel) : 0.0;
+
+    const Budget& b = sc.budget[FLIP_FIXED_POINT ? 1 : 0];
+    char why[128] = "";
+    if (!r.passed) std::snprintf(why, sizeof(why), "criteria");
+    else if (over(r.ticksToLevel, b.ticksToLevel, tolPct)) std::snprintf(why, sizeof(why), "ticks>%d", b.ticksToLevel);
+    else if (over(r.peakPwm, b.peakPwm, tolPct))           std::snprintf(why, sizeof(why), "peak>%d", b.peakPwm);
+    else if (over((double)r.energy, (double)b.energy, tolPct)) std::snprintf(why, sizeof(why), "energy>%ld", b.energy);
+    else if (timing && over(r.nsPerTick, b.nsPerTick, tolPct)) std::snprintf(why, sizeof(why), "ns>%.0f", b.nsPerTick);
+    const bool ok = why[0] == '\0';
+    if (!ok) ++failures;
+
+    std::printf("%-22s %4s %6d %4d %5d %7ld %8.1f  %s\n", sc.name, r.passed ? "yes" : "NO",
+                r.ticksToLevel, r.attempts, r.peakPwm, r.energy, r.nsPerTick, ok ? "ok" : why);
+
+    if (json) {
+      std::fprintf(json,
+                   "%s{\"name\": \"%s\", \"passed\": %s, \"within_budget\": %s, \"ticks_to_level\": %d, "
+                   "\"attempts\": %d, \"peak_pwm\": %d, \"peak_yaw\": %d, \"peak_pitch\": %d, "
+                   "\"peak_drive\": %d, \"energy\": %ld, \"ns_per_tick\": %.2f, "
+                   "\"budget\": {\"ticks_to_level\": %d, \"peak_pwm\": %d, \"energy\": %ld, \"ns_per_tick\": %.1f}}",
+                   first ? "" : ", ", sc.name, r.passed ? "true" : "false", ok ? "true" : "false",
+                   r.ticksToLevel, r.attempts, r.peakPwm, r.peakYaw, r.peakPitch, r.peakDrive,
+                   r.energy, r.nsPerTick,
+                   b.ticksToLevel, b.peakPwm, b.energy, b.nsPerTick);
+      first = false;
+    }
+  }
+  if (json) {
+    std::fprintf(json, "], \"failures\": %d}\n", failures);
+    std::fclose(json);
+  }
+
+  std::printf("[BENCH] %s build: %d/%zu scenarios within budget (tolerance %.1f%%)\n", BUILD_NAME,
+              (int)(sizeof(SCENARIOS) / sizeof(SCENARIOS[0])) - failures,
+              sizeof(SCENARIOS) / sizeof(SCENARIOS[0]), tolPct);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+// src/host_sim/flip_equiv.cpp
+//
+// Closed-loop float vs fixed-point check. flip_fixed_test compares the
+// FlipMath helpers one call at a time; this runs whole flips through the
+// plant on a grid of poses, payloads, terrain roll, strategies and phase
+// plans. Built once per FLIP_FIXED_POINT setting: the float build prints the
+// reference, the fixed build replays the grid and compares against it.
+//
+// Usage: ./flip_equiv > REF            (float build)
+//        ./flip_equiv_fx --compare REF (fixed build; REF may be - for stdin)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "sim_episode.h"
+
+static constexpr int MAX_TICKS = 3000;
+
+// Tolerances for the fixed build against the float reference. Most cases
+// match exactly. The rest are drive-assisted flips where the measured pitch
+// rate lands exactly on the lag threshold; the two builds can break that tie
+// differently, which moves one pulse train and the ticks after it.
+static constexpr int   TICK_TOL        = 1;    // plus TICK_TOL_PCT of the reference
+static constexpr int   TICK_TOL_PCT    = 5;
+static constexpr int   PWM_SUM_TOL_PCT = 5;
+static constexpr long  DRIVE_SUM_TOL   = 180;  // one pulse train, 3 ticks at 60
+static constexpr float POSE_TOL_DEG    = 1.0f; // controller epsilon
+
+static const float PAYLOADS[] = {1.0f, 2.0f};
+static const float ROLLS[]    = {-20.0f, 0.0f, 20.0f};
+static const float YAWS[]     = {0.0f, 137.5f, -90.0f};
+
+struct Case {
+  int   pitch0, yaw0, payload, roll;  // centideg / per-mille
+  int   strategy, concurrent;
+  int   completed, ticks;
+  int   pitchCd, yawCd;
+  long  jointPwmSum, drivePwmSum;
+};
+
+static std::vector<Case> run_grid() {
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+  fc.setAdaptiveStrategy(false);
+  fc.setPowerBudget(false);  // each case starts cold, independent of the last
+
+  std::vector<Case> out;
+  for (float payload : PAYLOADS) {
+    for (float roll : ROLLS) {
+      for (float yaw0 : YAWS) {
+        for (int p = -180; p < 180; p += 5) {
+          // Upright poses do not flip; each other pose has two strategies.
+          const int ap = std::abs(p);
+          if (ap <= 45) continue;
+          const int s0 = ap > 90 ? FlipController::STRAT_PITCH_STRAIGHT : FlipController::STRAT_YAW_LEFT;
+          for (int s = s0; s <= s0 + 1; ++s) {
+            for (int conc = 0; conc < 2; ++conc) {
+              g_imu = SimIMU{};
+              g_imu.payload  = payload;
+              g_imu.roll_deg = roll;
+              fc.setStrategyOverride((FlipController::Strategy)s);
+              fc.setConcurrentPhases(conc != 0);
+              SimEpisode ep = sim_run_flip(fc, (float)p, yaw0, MAX_TICKS);
+
+              Case c{};
+              c.pitch0 = p * 100;
+              c.yaw0 = (int)(yaw0 * 100.0f);
+              c.payload = (int)(payload * 1000.0f);
+              c.roll = (int)(roll * 100.0f);
+              c.strategy = s;
+              c.concurrent = conc;
+              c.completed = ep.completed;
+              c.ticks = ep.ticks;
+              c.pitchCd = (int)(ep.pitch * 100.0f);
+              c.yawCd = (int)(ep.yaw * 100.0f);
+              c.jointPwmSum = ep.jointPwmSum;
+              c.drivePwmSum = ep.drivePwmSum;
+              out.push_back(c);
+            }
+          }
+        }
+      }
+    }
+  }
+  return out;
+}
+
+static void print_case(FILE* f, const Case& c) {
+  std::fprintf(f, "%d %d %d %d %d %d %d %d %d %d %ld %ld\n", c.pitch0, c.yaw0, c.payload, c.roll,
+               c.strategy, c.concurrent, c.completed, c.ticks, c.pitchCd, c.yawCd, c.jointPwmSum,
+               c.drivePwmSum);
+}
+
+static bool read_case(FILE* f, Case& c) {
+  return std::fscanf(f, "%d %d %d %d %d %d %d %d %d %d %ld %ld", &c.pitch0, &c.yaw0, &c.payload, &c.roll,
+                     &c.strategy, &c.concurrent, &c.completed, &c.ticks, &c.pitchCd, &c.yawCd,
+                     &c.jointPwmSum, &c.drivePwmSum) == 12;
+}
+
+static int ang_dist_cd(int a, int b) {
+  int d = std::abs(a - b) % 36000;
+  return d > 18000 ? 36000 - d : d;
+}
+
+static bool within_pct(long v, long ref, long pct, long slack) {
+  return std::labs(v - ref) <= std::labs(ref) * pct / 100 + slack;
+}
+
+static int compare(const char* path, const std::vector<Case>& got) {
+  FILE* f = std::strcmp(path, "-") ? std::fopen(path, "r") : stdin;
+  if (!f) { std::perror(path); return 2; }
+  std::vector<Case> ref;
+  Case c;
+  while (read_case(f, c)) ref.push_back(c);
+  if (f != stdin) std::fclose(f);
+  if (ref.size() != got.size()) {
+    std::printf("[EQUIV] reference has %zu cases, this build ran %zu\n", ref.size(), got.size());
+    return 1;
+  }
+
+  long exact = 0, bad = 0, worstTicks = 0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    const Case& r = ref[i];
+    const Case& g = got[i];
+    if (r.pitch0 != g.pitch0 || r.yaw0 != g.yaw0 || r.payload != g.payload || r.roll != g.roll ||
+        r.strategy != g.strategy || r.concurrent != g.concurrent) {
+      std::printf("[EQUIV] case %zu: grid mismatch, reference is from another build\n", i);
+      return 1;
+    }
+    const long dt = std::labs((long)g.ticks - r.ticks);
+    if (dt > worstTicks) worstTicks = dt;
+    const bool same = g.completed == r.completed && g.ticks == r.ticks &&
+                      g.jointPwmSum == r.jointPwmSum && g.drivePwmSum == r.drivePwmSum;
+    const bool ok = g.completed == r.completed &&
+                    within_pct(g.ticks, r.ticks, TICK_TOL_PCT, TICK_TOL) &&
+                    ang_dist_cd(g.pitchCd, r.pitchCd) <= (int)(POSE_TOL_DEG * 100.0f) &&
+                    ang_dist_cd(g.yawCd, r.yawCd) <= (int)(POSE_TOL_DEG * 100.0f) &&
+                    within_pct(g.jointPwmSum, r.jointPwmSum, PWM_SUM_TOL_PCT, 2) &&
+                    within_pct(g.drivePwmSum, r.drivePwmSum, 0, DRIVE_SUM_TOL);
+    exact += same;
+    if (!ok && bad++ < 10) {
+      std::printf("  pitch0=%.0f yaw0=%.1f payload=%.1f roll=%.0f strat=%d conc=%d: "
+                  "float %s %d ticks pwm %ld/%ld, fixed %s %d ticks pwm %ld/%ld\n",
+                  r.pitch0 / 100.0, r.yaw0 / 100.0, r.payload / 1000.0, r.roll / 100.0, r.strategy,
+                  r.concurrent, r.completed ? "ok" : "stuck", r.ticks, r.jointPwmSum, r.drivePwmSum,
+                  g.completed ? "ok" : "stuck", g.ticks, g.jointPwmSum, g.drivePwmSum);
+    }
+  }
+  std::printf("[EQUIV] %zu closed-loop cases: %ld identical, %ld outside tolerance, worst %ld ticks apart\n",
+              ref.size(), exact, bad, worstTicks);
+  std::printf("[EQUIV] %s\n", bad ? "FAIL" : "PASS");
+  return bad ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  const char* refPath = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--compare") && i + 1 < argc) refPath = argv[++i];
+    else { std::fprintf(stderr, "usage: %s [--compare REF]\n", argv[0]); return 2; }
+  }
+
+  sim_headless_init();
+
+  std::vector<Case> got = run_grid();
+  if (!refPath) {
+    for (const Case& c : got) print_case(stdout, c);
+    return 0;
+  }
+  return compare(refPath, got);
+}
@@ -0,0 +1,123 @@
+// src/host_sim/flip_fixed_test.cpp
+//
+// Equivalence check and micro-benchmark for the two FlipMath paths.
+// Usage: ./flip_fixed_test [samples]   (default 4,000,000)
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "../controllers/FlipMath.h"
+
+namespace flt = flipmath::flt;
+namespace fx  = flipmath::fx;
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static inline uint32_t rng_u32() {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 7;
+  s_rng ^= s_rng << 17;
+  return (uint32_t)(s_rng >> 32);
+}
+
+// Centidegrees over several turns so wrap-around is exercised.
+static inline int32_t rng_centideg() { return (int32_t)(rng_u32() % 216001u) - 108000; }
+
+// Angular distance between two degree values, ignoring whole turns.
+static inline float ang_dist(float a, float b) {
+  float d = std::fmod(std::fabs(a - b), 360.0f);
+  return d > 180.0f ? 360.0f - d : d;
+}
+
+struct Check {
+  const char* name;
+  double      tol;
+  double      worst = 0.0;
+  long        fails = 0;
+
+  void add(double err) {
+    if (err > worst) worst = err;
+    if (err > tol) ++fails;
+  }
+};
+
+struct Gain {
+  float  kp;
+  int8_t maxPwm;
+};
+
+// FlipController's KP_YAW/KP_PITCH (1.0 PWM/deg) at its PWM limit (100).
+static const Gain GAINS[] = {{1.0f, 100}};
+
+int main(int argc, char** argv) {
+  const long n = (argc > 1) ? std::atol(argv[1]) : 4000000L;
+
+  Check conv  {"from_centideg [deg]", 0.0065};
+  Check delta {"delta [deg]",         0.012};
+  Check step  {"step_towards [deg]",  0.020};
+  Check pwm   {"p_cmd [pwm]",         1.0};
+
+  const float epsDeg  = 1.0f;
+  const float stepDeg = 1.2f;
+
+  for (long i = 0; i < n; ++i) {
+    int32_t a = rng_centideg();
+    int32_t b = rng_centideg();
+
+    flt::angle_t fa = flt::from_centideg(a), fb = flt::from_centideg(b);
+    fx::angle_t  xa = fx::from_centideg(a),  xb = fx::from_centideg(b);
+    conv.add(ang_dist(fx::to_deg(xa), fa));
+
+    flt::angle_t fd = flt::delta(fa, fb);
+    fx::angle_t  xd = fx::delta(xa, xb);
+    delta.add(ang_dist(fx::to_deg(xd), fd));
+
+    // Errors near +-180 legitimately differ in sign between the paths.
+    if (std::fabs(fd) < 179.0f) {
+      step.add(ang_dist(fx::to_deg(fx::step_towards(xa, xb, fx::deg(stepDeg))),
+                        flt::step_towards(fa, fb, flt::deg(stepDeg))));
+
+      const Gain& g = GAINS[i % (sizeof(GAINS) / sizeof(GAINS[0]))];
+      int8_t uf = flt::p_cmd(fd, flt::gain(g.kp), g.maxPwm, flt::deg(epsDeg));
+      int8_t ux = fx::p_cmd(xd, fx::gain(g.kp), g.maxPwm, fx::deg(epsDeg));
+      pwm.add(std::abs(uf - ux));
+    }
+  }
+
+  bool ok = true;
+  std::printf("[FIXED] %ld samples\n", n);
+  for (const Check* c : {&conv, &delta, &step, &pwm}) {
+    std::printf("  %-22s worst=%.4f tol=%.4f fails=%ld\n", c->name, c->worst, c->tol, c->fails);
+    ok = ok && c->fails == 0;
+  }
+
+  // ---- Benchmark: raw IMU centidegrees -> error -> PWM ----
+  std::vector<int32_t> in((size_t)n * 2);
+  for (auto& v : in) v = rng_centideg();
+
+  auto bench = [&](auto fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    int32_t acc = 0;
+    for (long i = 0; i < n; ++i) acc += fn(in[2 * i], in[2 * i + 1]);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)n;
+    return std::make_pair(ns, acc);
+  };
+
+  auto rf = bench([](int32_t cur, int32_t tgt) {
+    flt::angle_t e = flt::delta(flt::from_centideg(cur), flt::from_centideg(tgt));
+    return (int32_t)flt::p_cmd(e, flt::gain(1.0f), 100, flt::deg(1.0f));
+  });
+  auto rx = bench([](int32_t cur, int32_t tgt) {
+    fx::angle_t e = fx::delta(fx::from_centideg(cur), fx::from_centideg(tgt));
+    return (int32_t)fx::p_cmd(e, fx::gain(1.0f), 100, fx::deg(1.0f));
+  });
+
+  std::printf("[FIXED] bench: float=%.2f ns/op fixed=%.2f ns/op speedup=%.2fx (chk %d/%d)\n",
+              rf.first, rx.first, rf.first / rx.first, (int)rf.second, (int)rx.second);
+  std::printf("[FIXED] %s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
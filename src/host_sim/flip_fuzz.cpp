@@ -0,0 +1,220 @@
+// src/host_sim/flip_fuzz.cpp
+//
+// FlipController state-machine fuzzer. One input is a byte stream of ops
+// (ticks, triggers, aborts, enable/disable, IMU jumps/noise, raw phase
+// sequences, flash service) replayed against a fresh controller, flash and
+// clock; invariants are checked on every motor command and every tick.
+//
+//   libFuzzer: clang++ -fsanitize=fuzzer -DFLIP_FUZZ_LIBFUZZER ...
+//   AFL:       afl-clang-fast++ ...; ./flip_fuzz < input  (or a file path)
+//   seeded:    ./flip_fuzz --seed N --cases M   (property tester, default)
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "sim_episode.h"
+
+static constexpr int SETTLE_TICKS = 5000;  // budget to reach idle after the stream
+
+struct FuzzState {
+  bool     disabled = false;
+  uint64_t ticks    = 0;
+  const char* failure = nullptr;
+};
+
+static FuzzState* s_fuzz = nullptr;
+
+static void fuzz_fail(const char* what) {
+  if (s_fuzz && !s_fuzz->failure) s_fuzz->failure = what;
+}
+
+static void fuzz_motor_hook(const motors_action_t* a) {
+  if (!s_fuzz) return;
+  if (a->yaw   > FlipController::MAX_PWM_YAW   || a->yaw   < -FlipController::MAX_PWM_YAW)
+    fuzz_fail("yaw PWM outside +-MAX_PWM_YAW");
+  if (a->pitch > FlipController::MAX_PWM_PITCH || a->pitch < -FlipController::MAX_PWM_PITCH)
+    fuzz_fail("pitch PWM outside +-MAX_PWM_PITCH");
+  if (a->drive > FlipController::MAX_PWM_DRIVE || a->drive < -FlipController::MAX_PWM_DRIVE)
+    fuzz_fail("drive PWM outside +-MAX_PWM_DRIVE");
+  if (s_fuzz->disabled && (a->yaw || a->pitch || a->drive))
+    fuzz_fail("motor command while disabled");
+}
+
+static void check_indices(const FlipController& fc) {
+  if (fc.sequenceLength < 0 || fc.sequenceLength > FlipController::MAX_SEQUENCE)
+    fuzz_fail("sequenceLength outside phaseSequence");
+  if (fc.currentStepIndex < 0 || fc.currentStepIndex > fc.sequenceLength)
+    fuzz_fail("currentStepIndex past sequence end");
+}
+
+// Cursor over the input; reads past the end return 0.
+struct Reader {
+  const uint8_t* p;
+  size_t n;
+  size_t i = 0;
+  bool   more() const { return i < n; }
+  uint8_t u8() { return i < n ? p[i++] : 0; }
+  int16_t i16() { uint16_t lo = u8(); return (int16_t)(lo | (uint16_t)u8() << 8); }
+};
+
+// Runs one input. Returns nullptr on success or the violated invariant.
+static const char* run_one(const uint8_t* data, size_t size, uint64_t* ticksOut) {
+  FuzzState st;
+  s_fuzz = &st;
+  g_sim_motor_hook = fuzz_motor_hook;
+
+  // Nothing carries over from the previous case.
+  g_imu             = SimIMU{};
+  g_sim_flash       = SimFlash{};
+  g_sim_now_ms      = 0;
+  g_sim_task_notify = 0;
+
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+
+  Reader in{data, size};
+  uint32_t noiseSeed = 0x1234567u;
+  float    noiseAmp  = 0.0f;
+
+  auto tick = [&]() {
+    if (noiseAmp > 0.0f) {
+      noiseSeed = noiseSeed * 1664525u + 1013904223u;
+      float r = (float)(int32_t)(noiseSeed >> 8 & 0xFFFF) / 32768.0f - 1.0f;
+      g_imu.pitch_deg = sim_wrap_deg(g_imu.pitch_deg + r * noiseAmp);
+      g_imu.yaw_deg   = sim_wrap_deg(g_imu.yaw_deg - r * noiseAmp);
+    }
+    const uint32_t flashOps = g_sim_flash.erases + g_sim_flash.writes;
+    fc.loop();
+    g_sim_now_ms += 10;
+    if (g_sim_flash.erases + g_sim_flash.writes != flashOps) fuzz_fail("parameter flash written from loop()");
+    ++st.ticks;
+    check_indices(fc);
+  };
+
+  while (in.more() && !st.failure) {
+    switch (in.u8() % 11) {
+      case 0: { int n = in.u8() + 1; while (n-- && !st.failure) tick(); break; }
+      case 1: fc.triggerRecovery(); break;
+      case 2: fc.triggerRecoveryFromISR(); break;
+      case 3: fc.abortRecovery(); break;
+      case 4: fc.setDisabled(); st.disabled = true; break;
+      case 5: st.disabled = false; fc.setEnabled(); break;
+      case 6:
+        g_imu.pitch_deg = sim_wrap_deg(in.i16() / 100.0f);
+        g_imu.yaw_deg   = sim_wrap_deg(in.i16() / 100.0f);
+        break;
+      case 7: noiseAmp = (float)(in.u8() % 32); break;
+      case 8: {
+        FlipController::phase_t seq[FlipController::MAX_SEQUENCE + 4];
+        int len = in.u8() % (FlipController::MAX_SEQUENCE + 4);
+        for (int k = 0; k < len; ++k)
+          seq[k] = (FlipController::phase_t)(in.u8() % (FlipController::PH_PITCH_UP_YAW + 1));
+        fc.startSequence(seq, len);
+        check_indices(fc);
+        break;
+      }
+      case 9: fc.setConcurrentPhases(in.u8() & 1); break;
+      case 10: fc.serviceFlash(); break;
+    }
+  }
+
+  // Liveness: with a quiet IMU the controller must get back to idle.
+  noiseAmp = 0.0f;
+  for (int k = 0; k < SETTLE_TICKS && fc.busy() && !st.failure; ++k) tick();
+  if (fc.busy()) fuzz_fail("no return to idle after settle window");
+
+  fc.abortRecovery();
+  if (ticksOut) *ticksOut += st.ticks;
+  g_sim_motor_hook = nullptr;
+  s_fuzz = nullptr;
+  return st.failure;
+}
+
+#ifdef FLIP_FUZZ_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  static bool once = (sim_headless_init(), true);
+  (void)once;
+  if (const char* f = run_one(data, size, nullptr)) {
+    std::fprintf(stderr, "[FUZZ] invariant violated: %s\n", f);
+    std::abort();
+  }
+  return 0;
+}
+
+#else
+
+static std::vector<uint8_t> read_all(FILE* f) {
+  std::vector<uint8_t> buf;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+  return buf;
+}
+
+static int replay(FILE* f, const char* name) {
+  std::vector<uint8_t> buf = read_all(f);
+  if (const char* fail = run_one(buf.data(), buf.size(), nullptr)) {
+    std::fprintf(stderr, "[FUZZ] %s: invariant violated: %s\n", name, fail);
+    std::abort();
+  }
+  std::printf("[FUZZ] %s: ok (%zu bytes)\n", name, buf.size());
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  sim_headless_init();
+
+  uint64_t seed  = 1;
+  long     cases = 20000;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)       seed  = std::strtoull(argv[++i], nullptr, 0);
+    else if (!std::strcmp(argv[i], "--cases") && i + 1 < argc) cases = std::atol(argv[++i]);
+    else if (!std::strcmp(argv[i], "-"))                       return replay(stdin, "stdin");
+    else files.push_back(argv[i]);
+  }
+
+  if (!files.empty()) {
+    for (const char* path : files) {
+      FILE* f = std::fopen(path, "rb");
+      if (!f) { std::perror(path); return 2; }
+      replay(f, path);
+      std::fclose(f);
+    }
+    return 0;
+  }
+
+  // Seeded property tester: random op streams, weighted towards long runs.
+  uint64_t rng = seed * 0x9E3779B97F4A7C15ull + 1;
+  auto next = [&]() { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return rng; };
+
+  std::vector<uint8_t> input;
+  uint64_t ticks = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (long c = 0; c < cases; ++c) {
+    input.resize(16 + next() % 240);
+    for (auto& b : input) b = (uint8_t)next();
+
+    if (const char* fail = run_one(input.data(), input.size(), &ticks)) {
+      char name[64];
+      std::snprintf(name, sizeof(name), "crash-seed%llu-case%ld", (unsigned long long)seed, c);
+      if (FILE* f = std::fopen(name, "wb")) {
+        std::fwrite(input.data(), 1, input.size(), f);
+        std::fclose(f);
+      }
+      std::printf("[FUZZ] seed=%llu case=%ld: %s (input saved to %s)\n",
+                  (unsigned long long)seed, c, fail, name);
+      return 1;
+    }
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  std::printf("[FUZZ] seed=%llu cases=%ld ticks=%llu (%.2f Mticks/s) PASS\n",
+              (unsigned long long)seed, cases, (unsigned long long)ticks, ticks / sec / 1e6);
+  return 0;
+}
+
+#endif
@@ -4,15 +4,101 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <thread>
 #include <chrono>
 #include <cmath>
 #include <atomic>
+#include <mutex>
+
+// Controller statics that one robot's task owns. A robot's other tasks
+// (and other robots) each see their own copy.
+#define SIM_THREAD_LOCAL thread_local
+
+/* ====================== Sim types ===================== */
+struct imu_data_t {
+  int32_t yaw;    // centideg, matches imu/imu.h
+  int32_t pitch;  // centideg
+  int32_t roll;   // centideg
+};
+
+struct SimIMU {
+  float pitch_deg = 0.0f;
+  float yaw_deg   = 0.0f;
+  float roll_deg  = 0.0f;       // terrain cross-slope; the plant never changes it
+  float pitch_rate_dps = 0.0f;  // momentum from the drive train
+  float payload   = 1.0f;       // body inertia relative to the bare robot
+};
+
+struct motors_action_t {
+  int8_t drive = 0;
+  int8_t rotate = 0;
+  int8_t yaw = 0;
+  int8_t pitch = 0;
+  int8_t auto_neutral_joints = 0;
+  int8_t drive_pulse = 0;
+  int8_t flip_mode = 0;
+};
+
+// Parameter flash: a per-robot RAM image of a NOR part, erased (0xFF)
+// until first use. Like the real part, programming only clears bits, so a
+// write over old data without a sector erase (FlexSPI NOR ops below)
+// corrupts it. flash_read/flash_write return 0 on success and -1 for an
+// out-of-range access. busyUs adds up the datasheet time the part would
+// have blocked the caller (typical 4 KB erase, 256 B page program).
+static constexpr int      SIM_FLASH_SIZE       = 0x2000;
+static constexpr int      SIM_FLASH_SECTOR     = 0x1000;
+static constexpr int      SIM_FLASH_PAGE       = 256;
+static constexpr uint32_t SIM_FLASH_ERASE_US   = 45000;
+static constexpr uint32_t SIM_FLASH_PROGRAM_US = 700;
+struct SimFlash {
+  uint8_t  bytes[SIM_FLASH_SIZE];
+  uint32_t erases = 0, writes = 0;
+  uint64_t busyUs = 0;
+  SimFlash() { std::memset(bytes, 0xFF, sizeof(bytes)); }
+};
+
+/* ===================== Robot state ==================== */
+// Everything one simulated robot's firmware sees as globals. Each host
+// thread starts on a robot of its own, so one process can host many
+// independent robots (fleet_server); a task started with xTaskCreate runs
+// on its creator's robot, as tasks on one MCU share its memory.
+struct SimRobot {
+  SimIMU                imu;
+  uint32_t              nowMs = 0;       // virtual clock; whoever steps loop() advances it
+  std::atomic<uint32_t> taskNotify{0};   // pending task notifications; starts empty
+  motors_action_t       motors{};        // what the motors run; the plant integrates this
+  void (*motorHook)(const motors_action_t*) = nullptr;  // sees every command (fuzzers, benches)
+  SimFlash              flash;
+  bool                  verbose    = true;  // headless runs clear this to silence per-tick output
+  bool                  spawnTasks = true;  // harnesses that step loop() themselves clear this
+  // Held by whichever of the robot's tasks is running; released only in
+  // vTaskDelay(). Tasks interleave as on one core, so critical sections
+  // need no lock of their own.
+  std::mutex            cpu;
+};
+
+inline thread_local SimRobot  t_sim_own_robot;
+inline thread_local SimRobot* t_sim_robot   = nullptr;  // set in spawned tasks
+inline thread_local bool      t_sim_in_task = false;
+inline SimRobot& sim_robot() { return t_sim_robot ? *t_sim_robot : t_sim_own_robot; }
+
+#define g_imu             (sim_robot().imu)
+#define g_sim_now_ms      (sim_robot().nowMs)
+#define g_sim_task_notify (sim_robot().taskNotify)
+#define g_sim_motors      (sim_robot().motors)
+#define g_sim_motor_hook  (sim_robot().motorHook)
+#define g_sim_flash       (sim_robot().flash)
+#define g_sim_verbose     (sim_robot().verbose)
+#define g_sim_spawn_tasks (sim_robot().spawnTasks)
+
+/* ======================= Logging ====================== */
+#define SIM_LOG(...) do { if (g_sim_verbose) std::printf(__VA_ARGS__); } while (0)
 
 /* ====================== Platform ====================== */
 inline void platform_init() {}
-inline uint32_t platform_millis() { static uint32_t t=0; return ++t; }
-inline void platform_log(const char* s) { std::printf("[LOG] %s\n", s); }
+inline uint32_t platform_millis() { return g_sim_now_ms; }
+inline void platform_log(const char* s) { SIM_LOG("[LOG] %s\n", s); }
 
 /* ======================= FreeRTOS ===================== */
 using TickType_t   = uint32_t;
@@ -36,21 +122,36 @@ using TaskHandle_t = void*;
 #endif
 
 inline void vTaskDelay(TickType_t ms) {
+  if (t_sim_in_task) sim_robot().cpu.unlock();
   std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  if (t_sim_in_task) sim_robot().cpu.lock();
 }
 inline void vTaskDelete(void*) {}
+// A robot's tasks never run at the same time (SimRobot::cpu).
+#ifndef taskENTER_CRITICAL
+#define taskENTER_CRITICAL() ((void)0)
+#define taskEXIT_CRITICAL()  ((void)0)
+#endif
 inline BaseType_t xTaskCreate(void (*fn)(void*), const char*, uint16_t,
                               void* param, uint32_t, TaskHandle_t*) {
-  std::thread([=]{ fn(param); }).detach();
+  if (!g_sim_spawn_tasks) return pdTRUE;
+  SimRobot* robot = &sim_robot();
+  std::thread([=] {
+    t_sim_robot   = robot;
+    t_sim_in_task = true;
+    std::lock_guard<std::mutex> running(robot->cpu);
+    fn(param);
+  }).detach();
   return pdTRUE;
 }
-inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) {
-  static int first = 1;
-  if (first) { first = 0; return 1; }
-  return 0;
+// Notifications may come from threads outside the robot's tasks.
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t) {
+  uint32_t n = g_sim_task_notify.load();
+  while (n && !g_sim_task_notify.compare_exchange_weak(n, clearOnExit ? 0 : n - 1)) {}
+  return n;
 }
-inline void     xTaskNotifyGive(TaskHandle_t) {}
-inline void     vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t*) {}
+inline void     xTaskNotifyGive(TaskHandle_t) { ++g_sim_task_notify; }
+inline void     vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t*) { ++g_sim_task_notify; }
 inline void     portYIELD_FROM_ISR(BaseType_t) {}
 
 
@@ -63,46 +164,29 @@ inline void lights_set(int, int) {}
 inline void lights_blink(int, int) {}
 
 /* ======================== IMU ========================= */
-struct imu_data_t {
-  int16_t yaw;
-  int16_t pitch;
-  // roll removed
-};
-
-struct SimIMU {
-  float pitch_deg = 0.0f;
-  float yaw_deg   = 0.0f;
-};
-
-extern SimIMU g_imu;
-
 inline imu_data_t get_imu_data() {
   imu_data_t out;
-  out.yaw   = static_cast<int16_t>(std::lround(g_imu.yaw_deg * 100.0f));
-  out.pitch = static_cast<int16_t>(std::lround(g_imu.pitch_deg * 100.0f));
+  out.yaw   = static_cast<int32_t>(std::lround(g_imu.yaw_deg * 100.0f));
+  out.pitch = static_cast<int32_t>(std::lround(g_imu.pitch_deg * 100.0f));
+  out.roll  = static_cast<int32_t>(std::lround(g_imu.roll_deg * 100.0f));
   return out;
 }
 
 /* ==================== Motors / Actions ================ */
-struct motors_action_t {
-  int8_t drive = 0;
-  int8_t rotate = 0;
-  int8_t yaw = 0;
-  int8_t pitch = 0;
-  int8_t auto_neutral_joints = 0;
-  int8_t drive_pulse = 0;
-  int8_t flip_mode = 0;
-};
-
 inline void motors_init() {}
 
+// Plant model: advances g_imu by one tick of the given command (sim_episode.cpp).
+void sim_plant_step(const motors_action_t& act, float dt);
+
 inline void set_motors(const motors_action_t* a) {
-  static int8_t py=127, pp=127, pd=127, pm=127;
+  g_sim_motors = *a;
+  if (g_sim_motor_hook) g_sim_motor_hook(a);
+  static thread_local int8_t py=127, pp=127, pd=127, pm=127;
   if (a->yaw==py && a->pitch==pp && a->drive==pd && a->flip_mode==pm) return;
   py=a->yaw; pp=a->pitch; pd=a->drive; pm=a->flip_mode;
 
-  std::printf("[SIM] set_motors: yaw=%d pitch=%d drive=%d mode=%d\n",
-              (int)a->yaw, (int)a->pitch, (int)a->drive, (int)a->flip_mode);
+  SIM_LOG("[SIM] set_motors: yaw=%d pitch=%d drive=%d mode=%d\n",
+          (int)a->yaw, (int)a->pitch, (int)a->drive, (int)a->flip_mode);
 }
 
 
@@ -121,11 +205,42 @@ inline void usb_host_init() {}
 
 /* ======================== Flash ======================= */
 inline void flash_init() {}
-inline int  flash_read(int, void*, int) { return 0; }
-inline int  flash_write(int, const void*, int) { return 0; }
+inline int flash_read(int addr, void* buf, int len) {
+  if (addr < 0 || len < 0 || addr + len > SIM_FLASH_SIZE) return -1;
+  std::memcpy(buf, g_sim_flash.bytes + addr, (size_t)len);
+  return 0;
+}
+inline int flash_write(int addr, const void* buf, int len) {
+  if (addr < 0 || len < 0 || addr + len > SIM_FLASH_SIZE) return -1;
+  const uint8_t* src = static_cast<const uint8_t*>(buf);
+  for (int i = 0; i < len; ++i) g_sim_flash.bytes[addr + i] &= src[i];
+  g_sim_flash.writes++;
+  g_sim_flash.busyUs += (uint64_t)((len + SIM_FLASH_PAGE - 1) / SIM_FLASH_PAGE) * SIM_FLASH_PROGRAM_US;
+  return 0;
+}
+
+/* ==================== FlexSPI NOR ===================== */
+// The SDK's status codes and the NOR ops' sector erase, on the same image.
+typedef int32_t status_t;
+enum { kStatus_Success = 0, kStatus_Fail = 1 };
+struct FLEXSPI_Type { uint32_t unused; };
+#define FLEXSPI ((FLEXSPI_Type*)0x402A8000u)  // never dereferenced
+
+// Erases the one sector at a sector-aligned offset.
+inline status_t flexspi_nor_flash_erase_sector(FLEXSPI_Type*, uint32_t addr) {
+  if (addr % SIM_FLASH_SECTOR || addr + SIM_FLASH_SECTOR > (uint32_t)SIM_FLASH_SIZE) return kStatus_Fail;
+  std::memset(g_sim_flash.bytes + addr, 0xFF, SIM_FLASH_SECTOR);
+  g_sim_flash.erases++;
+  g_sim_flash.busyUs += SIM_FLASH_ERASE_US;
+  return kStatus_Success;
+}
 
 /* ============== External Flash Map / Net ============== */
-inline int  ext_map_addr(const char*) { return 0x10000; }
+// The strategy table's region is the image's second sector; every other
+// name maps to the default offset.
+inline int ext_map_addr(const char* region) {
+  return std::strcmp(region, "flip_strategy") == 0 ? SIM_FLASH_SECTOR : 0x10000;
+}
 inline void network_init() {}
 inline void network_poll() {}
 
@@ -4,10 +4,10 @@
 #include <cmath>
 #include <thread>
 #include <chrono>
+#include <cstring>
 #ifdef HOST_SIM
 #include "mock_all.h"
-
-SimIMU g_imu;
+#include "sim_episode.h"
 
 static inline int32_t deg_to_centideg(float d) {
   return (int32_t) std::lround(d * 100.0f);
@@ -81,7 +81,297 @@ static void integrate_pose_from_pwm(float dt) {
 // --- Controller ---
 #include "../controllers/FlipController.h"
 
-int main() {
+// Orientation sweep: concurrent vs. sequential side-recovery phases.
+static int run_phase_sweep() {
+  static constexpr int MAX_TICKS = 3000;
+  RSBL8512 yawMotor(0);
+  RSBL8512 pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+  fc.setAdaptiveStrategy(false);
+
+  std::puts("[SIM] phase sweep: ticks to finish (10 ms/tick)");
+  std::puts("  pitch0   sequential  concurrent  saved");
+  long totalSeq = 0, totalCon = 0;
+  for (int p = -180; p < 180; p += 15) {
+    fc.setConcurrentPhases(false);
+    SimEpisode seq = sim_run_flip(fc, (float)p, 0.0f, MAX_TICKS);
+    fc.setConcurrentPhases(true);
+    SimEpisode con = sim_run_flip(fc, (float)p, 0.0f, MAX_TICKS);
+
+    totalSeq += seq.ticks;
+    totalCon += con.ticks;
+    std::printf("  %6d   %10d%s  %10d%s  %5d\n", p,
+                seq.ticks, seq.completed ? " " : "!",
+                con.ticks, con.completed ? " " : "!",
+                seq.ticks - con.ticks);
+  }
+  std::printf("[SIM] total: sequential=%ld concurrent=%ld saved=%ld ticks (%.0f ms)\n",
+              totalSeq, totalCon, totalSeq - totalCon,
+              (double)(totalSeq - totalCon) * DT_SEC * 1000.0);
+  return 0;
+}
+
+// Payload sweep: PITCH_DOWN with and without drive-train assist.
+static int run_payload_sweep() {
+  static constexpr int MAX_TICKS = 3000;
+  static const float PAYLOADS[] = {1.0f, 1.5f, 2.0f, 3.0f};
+  static const float POSES[]    = {180.0f, 135.0f, -90.0f};
+  RSBL8512 yawMotor(0);
+  RSBL8512 pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+  fc.setAdaptiveStrategy(false);
+
+  std::puts("[SIM] payload sweep: ticks / joint |PWM| sum / drive |PWM| sum");
+  std::puts("  payload  pitch0 |   joint only         |   with drive assist");
+  for (float payload : PAYLOADS) {
+    g_imu.payload = payload;
+    for (float pose : POSES) {
+      fc.setDriveAssist(false);
+      SimEpisode off = sim_run_flip(fc, pose, 0.0f, MAX_TICKS);
+      fc.setDriveAssist(true);
+      SimEpisode on  = sim_run_flip(fc, pose, 0.0f, MAX_TICKS);
+      std::printf("  %7.1f  %6.0f | %5d%s %6ld %6ld  | %5d%s %6ld %6ld\n", payload, pose,
+                  off.ticks, off.completed ? " " : "!", off.jointPwmSum, off.drivePwmSum,
+                  on.ticks,  on.completed  ? " " : "!", on.jointPwmSum,  on.drivePwmSum);
+    }
+  }
+  g_imu.payload = 1.0f;
+  return 0;
+}
+
+// Back-to-back heavy flips: thermal/battery budget on vs off. Upside-down
+// flips load the drive train. Side flips on a steep cross slope stall the
+// uphill yaw and pitch joints, so there the servos are the constraint.
+struct ThermalCase {
+  const char*        title;
+  float              pitch0;
+  float              roll;       // terrain cross-slope, deg
+  int                restTicks;
+  PowerBudget::Motor show[2];    // motors tabled as heat % of the trip limit
+};
+
+static const ThermalCase THERMAL_CASES[] = {
+  {"upside down",         135.0f,   0.0f, 20, {PowerBudget::M_DRIVE, PowerBudget::M_PITCH}},
+  {"left side, 60 slope", -90.0f, -60.0f, 20, {PowerBudget::M_YAW,   PowerBudget::M_PITCH}},
+};
+
+static const char* const MOTOR_NAMES[PowerBudget::M_COUNT] = {"yaw%", "pitch%", "drive%"};
+
+static bool over_trip(const PowerBudget& p) {
+  for (int m = 0; m < PowerBudget::M_COUNT; ++m)
+    if (p.heatPermille((PowerBudget::Motor)m) > 1000) return true;
+  return false;
+}
+
+static void run_thermal_case(const ThermalCase& tc) {
+  static constexpr int MAX_TICKS = 3000;
+  static constexpr int FLIPS     = 40;
+  const PowerBudget::Motor m0 = tc.show[0], m1 = tc.show[1];
+
+  std::printf("[SIM] thermal sweep, %s: payload %.1f, pitch0 %.0f, roll %.0f, %d ms rest between flips\n",
+              tc.title, g_imu.payload, tc.pitch0, tc.roll, tc.restTicks * 10);
+  std::printf("  flip | budget off: ticks      J %6s %6s | budget on: ticks      J %6s %6s\n",
+              MOTOR_NAMES[m0], MOTOR_NAMES[m1], MOTOR_NAMES[m0], MOTOR_NAMES[m1]);
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController off(yawMotor, pitchMotor), on(yawMotor, pitchMotor);
+  off.setPowerBudget(false);
+  off.setAdaptiveStrategy(false);
+  on.setAdaptiveStrategy(false);
+
+  g_imu.roll_deg = tc.roll;
+  float offJ = 0.0f, onJ = 0.0f;
+  int   offTrip = -1, onTrip = -1;
+  for (int i = 0; i < FLIPS; ++i) {
+    SimEpisode a = sim_run_flip(off, tc.pitch0, 0.0f, MAX_TICKS);
+    for (int k = 0; k < tc.restTicks; ++k) off.loop();
+    SimEpisode b = sim_run_flip(on, tc.pitch0, 0.0f, MAX_TICKS);
+    for (int k = 0; k < tc.restTicks; ++k) on.loop();
+
+    const PowerBudget& pa = off.powerBudget();
+    const PowerBudget& pb = on.powerBudget();
+    if (offTrip < 0 && over_trip(pa)) offTrip = i + 1;
+    if (onTrip < 0 && over_trip(pb)) onTrip = i + 1;
+    offJ += a.energyJ;
+    onJ  += b.energyJ;
+    if ((i + 1) % 4 != 0) continue;
+    std::printf("  %4d |            %5d %6.1f %6.1f %6.1f%s |           %5d %6.1f %6.1f %6.1f\n", i + 1,
+                a.ticks, a.energyJ, pa.heatPermille(m0) / 10.0f, pa.heatPermille(m1) / 10.0f,
+                over_trip(pa) ? "!" : " ",
+                b.ticks, b.energyJ, pb.heatPermille(m0) / 10.0f, pb.heatPermille(m1) / 10.0f);
+  }
+  std::printf("[SIM] energy/flip: off=%.2f J on=%.2f J; unbudgeted run %s, budgeted run %s\n",
+              offJ / FLIPS, onJ / FLIPS,
+              offTrip > 0 ? "exceeds the I2t trip limit" : "stays under the trip limit",
+              onTrip > 0 ? "exceeds it" : "stays under it");
+  if (offTrip > 0) std::printf("[SIM] unbudgeted trip at flip %d\n", offTrip);
+  g_imu.roll_deg = 0.0f;
+}
+
+static int run_thermal_sweep() {
+  const bool verbose = g_sim_verbose;
+  g_sim_verbose = false;
+  g_imu.payload = 3.0f;
+  for (const ThermalCase& tc : THERMAL_CASES) run_thermal_case(tc);
+  g_imu.payload = 1.0f;
+  g_sim_verbose = verbose;
+  return 0;
+}
+
+// Randomized terrain: the adaptive controller against a per-episode oracle
+// (both strategies run on a probe controller) and the legacy fixed plan.
+struct LearnWindow {
+  int  episodes = 0, decided = 0, fastest = 0;
+  long learner = 0, oracle = 0, legacy = 0;
+};
+
+static void print_learn_window(const char* label, const LearnWindow& w) {
+  std::printf("  %-10s %8d %8.0f%% %9.1f %8.1f %8.1f\n", label, w.episodes,
+              w.decided ? 100.0 * w.fastest / w.decided : 100.0,
+              (double)w.learner / w.episodes, (double)w.oracle / w.episodes,
+              (double)w.legacy / w.episodes);
+}
+
+// Ticks until level, or maxTicks if the robot never gets there. An
+// upside-down flip stops on a side, so recovery is triggered again from
+// wherever the robot stopped, as an operator would; strategy gets the first
+// flip's strategy.
+static int run_to_level(FlipController& fc, float pitch0, int maxTicks, FlipController::Strategy* strategy) {
+  static constexpr float LEVEL_EPS_DEG = 12.0f;
+  static constexpr int   MAX_ATTEMPTS  = 3;
+  float pitch = pitch0, yaw = 0.0f;
+  int   ticks = 0;
+  for (int attempt = 0; attempt < MAX_ATTEMPTS && ticks < maxTicks; ++attempt) {
+    const SimEpisode ep = sim_run_flip(fc, pitch, yaw, maxTicks - ticks);
+    if (attempt == 0 && strategy) *strategy = fc.lastStrategy();
+    ticks += ep.ticks;
+    if (!ep.completed) break;
+    if (std::fabs(ep.pitch) <= LEVEL_EPS_DEG) return ticks;
+    pitch = ep.pitch;
+    yaw   = ep.yaw;
+  }
+  return maxTicks;
+}
+
+static LearnWindow run_learn_window(FlipController& fc, FlipController& probe, uint32_t& rng, int episodes) {
+  static constexpr int MAX_TICKS = 3000;
+  auto uniform = [&rng](float lo, float hi) {
+    rng = rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(rng >> 8) / 16777216.0f;
+  };
+
+  LearnWindow w;
+  for (int i = 0; i < episodes; ++i) {
+    rng = rng * 1664525u + 1013904223u;
+    const int   kind   = (int)((rng >> 16) % 3);
+    // Right-side poses past 90 deg already classify as upside down.
+    const float pitch0 = kind == 0 ? uniform(-105.0f, -75.0f)
+                       : kind == 1 ? uniform(75.0f, 90.0f)
+                                   : uniform(170.0f, 180.0f);
+    g_imu.roll_deg = uniform(-30.0f, 30.0f);
+
+    const bool upside = kind == 2;
+    const FlipController::Strategy a0 = upside ? FlipController::STRAT_PITCH_STRAIGHT : FlipController::STRAT_YAW_LEFT;
+    const FlipController::Strategy a1 = upside ? FlipController::STRAT_PITCH_SCORPION : FlipController::STRAT_YAW_RIGHT;
+    probe.setStrategyOverride(a0);
+    const int t0 = run_to_level(probe, pitch0, MAX_TICKS, nullptr);
+    probe.setStrategyOverride(a1);
+    const int t1 = run_to_level(probe, pitch0, MAX_TICKS, nullptr);
+
+    FlipController::Strategy chosen;
+    const int ticks = run_to_level(fc, pitch0, MAX_TICKS, &chosen);
+    ++w.episodes;
+    w.learner += ticks;
+    w.oracle  += t0 < t1 ? t0 : t1;
+    w.legacy  += kind == 1 ? t1 : t0;
+    if (std::abs(t0 - t1) > 1) {
+      ++w.decided;
+      if (chosen == (t0 < t1 ? a0 : a1)) ++w.fastest;
+    }
+  }
+  return w;
+}
+
+static int run_learn_sweep() {
+  static constexpr int WINDOWS = 6;
+  static constexpr int WINDOW  = 100;
+  static const char* ORIENT_NAMES[] = {"upright", "left", "right", "upside"};
+  static const char* TILT_NAMES[]   = {"roll<0", "flat", "roll>0"};
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor), probe(yawMotor, pitchMotor);
+  probe.setAdaptiveStrategy(false);
+  // Back-to-back flips would otherwise compare thermal derating, not terrain.
+  fc.setPowerBudget(false);
+  probe.setPowerBudget(false);
+  uint32_t rng = 0x5EEDu;
+
+  std::puts("[SIM] strategy learning: random side/upside-down poses, roll in [-30, 30] deg");
+  std::puts("  window     episodes  fastest  ticks:ucb   oracle   legacy");
+  for (int k = 0; k < WINDOWS; ++k) {
+    char label[16];
+    std::snprintf(label, sizeof(label), "%d-%d", k * WINDOW, (k + 1) * WINDOW);
+    print_learn_window(label, run_learn_window(fc, probe, rng, WINDOW));
+  }
+
+  std::puts("[SIM] learned table: n / mean reward (per-mille) per strategy arm");
+  const StrategyTable& t = fc.strategyStats();
+  for (uint8_t o = FlipController::ORIENT_LEFT; o <= FlipController::ORIENT_UPSIDE_DOWN; ++o) {
+    for (int b = 0; b < StrategyTable::TILT_COUNT; ++b) {
+      const StrategyTable::Cell& c0 = t.cell(o, (StrategyTable::Tilt)b, 0);
+      const StrategyTable::Cell& c1 = t.cell(o, (StrategyTable::Tilt)b, 1);
+      std::printf("  %-7s %-7s  arm0 %4u / %4u   arm1 %4u / %4u\n", ORIENT_NAMES[o], TILT_NAMES[b],
+                  c0.n, c0.n ? c0.rewardSum / c0.n : 0, c1.n, c1.n ? c1.rewardSum / c1.n : 0);
+    }
+  }
+
+  // A rebooted controller picks the stats back up from parameter flash.
+  const bool saved = fc.strategyStats().save();
+  FlipController rebooted(yawMotor, pitchMotor);
+  rebooted.setPowerBudget(false);
+  const bool loaded = rebooted.strategyStats().load();
+  std::printf("[SIM] parameter flash: save=%s load=%s; %u sector erases, %.0f ms blocked in the params task\n",
+              saved ? "ok" : "FAIL", loaded ? "ok" : "FAIL", g_sim_flash.erases, g_sim_flash.busyUs / 1000.0);
+  print_learn_window("reboot", run_learn_window(rebooted, probe, rng, WINDOW));
+
+  g_imu.roll_deg = 0.0f;
+  return loaded ? 0 : 1;
+}
+
+static int run_headless(const char* mode) {
+  if (std::strcmp(mode, "sweep") == 0)   return run_phase_sweep();
+  if (std::strcmp(mode, "payload") == 0) return run_payload_sweep();
+  if (std::strcmp(mode, "thermal") == 0) return run_thermal_sweep();
+  if (std::strcmp(mode, "learn") == 0)   return run_learn_sweep();
+  return -1;
+}
+
+static int usage(const char* argv0) {
+  std::fprintf(stderr, "usage: %s [sweep|payload|thermal|learn] [--record FILE]\n", argv0);
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  // Headless modes: ./sim <mode> [--record FILE] writes every episode to FILE.
+  if (argc > 1) {
+    const char* recordPath = nullptr;
+    for (int i = 2; i < argc; ++i) {
+      if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+      else return usage(argv[0]);
+    }
+    EpisodeLogWriter log;
+    if (recordPath) {
+      if (!log.open(recordPath)) { std::perror(recordPath); return 2; }
+      g_sim_episode_log = &log;
+    }
+    const int rc = run_headless(argv[1]);
+    g_sim_episode_log = nullptr;
+    if (rc < 0) return usage(argv[0]);
+    if (recordPath) {
+      if (!log.close()) { std::perror(recordPath); return 2; }
+      std::printf("[SIM] recorded %u episodes, %u ticks to %s\n", log.episodes(), log.rows(), recordPath);
+    }
+    return rc;
+  }
+
   std::puts("[SIM] Flip simulation");
   std::puts("Choose initial position:\n  1) On Left side\n  2) On Right side\n  3) Upside down");
   std::printf("Enter 1/2/3: ");
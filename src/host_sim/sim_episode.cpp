@@ -0,0 +1,126 @@
+// src/host_sim/sim_episode.cpp
+#include "sim_episode.h"
+#include <cmath>
+#include <cstdlib>
+
+thread_local EpisodeLogWriter* g_sim_episode_log = nullptr;
+
+// Joint rates are per PWM count (legacy kinematic model), divided by payload.
+// Drive PWM accelerates the body in pitch; the momentum bleeds off through
+// ground friction.
+static constexpr float JOINT_YAW_RATE_DPS   = 90.0f;
+static constexpr float JOINT_PITCH_RATE_DPS = 120.0f;
+static constexpr float DRIVE_ACCEL_DPS2     = 55.0f;   // per drive PWM count
+static constexpr float DRIVE_DAMPING_HZ     = 20.0f;
+// Cross-slope (g_imu.roll_deg) loads a joint moving uphill; positive joint
+// commands run uphill on negative roll. Downhill motion is not sped up.
+static constexpr float TERRAIN_LOAD         = 1.2f;
+
+float sim_wrap_deg(float a) {
+  while (a <= -180.0f) a += 360.0f;
+  while (a > 180.0f) a -= 360.0f;
+  return a;
+}
+
+void sim_headless_init(void (*motorHook)(const motors_action_t*)) {
+  g_sim_verbose     = false;
+  g_sim_spawn_tasks = false;
+  g_sim_motor_hook  = motorHook;
+}
+
+static float terrain_factor(int8_t cmd) {
+  if (cmd == 0) return 1.0f;
+  float load = -TERRAIN_LOAD * std::sin(g_imu.roll_deg * 0.017453293f) * (cmd > 0 ? 1.0f : -1.0f);
+  return load > 0.0f ? 1.0f - load : 1.0f;
+}
+
+void sim_plant_step(const motors_action_t& act, float dt) {
+  const float inertia = g_imu.payload > 0.1f ? g_imu.payload : 0.1f;
+
+  g_imu.pitch_rate_dps += (float)act.drive * DRIVE_ACCEL_DPS2 * dt / inertia;
+  g_imu.pitch_rate_dps *= 1.0f - DRIVE_DAMPING_HZ * dt;
+
+  float pitch_change = (float)act.pitch * dt * JOINT_PITCH_RATE_DPS / inertia * terrain_factor(act.pitch)
+                     + g_imu.pitch_rate_dps * dt;
+  float yaw_change   = (float)act.yaw   * dt * JOINT_YAW_RATE_DPS / inertia * terrain_factor(act.yaw);
+
+  g_imu.pitch_deg = sim_wrap_deg(g_imu.pitch_deg + pitch_change);
+  g_imu.yaw_deg   = sim_wrap_deg(g_imu.yaw_deg + yaw_change);
+}
+
+static int16_t centideg(float d) { return (int16_t)std::lround(d * 100.0f); }
+
+static thread_local motors_action_t s_lastCmd{};
+static thread_local int             s_peakYaw = 0, s_peakPitch = 0, s_peakDrive = 0;
+
+static void raise_to(int& peak, int8_t cmd) {
+  if (std::abs(cmd) > peak) peak = std::abs(cmd);
+}
+
+static void episode_motor_hook(const motors_action_t* a) {
+  s_lastCmd = *a;
+  raise_to(s_peakYaw, a->yaw);
+  raise_to(s_peakPitch, a->pitch);
+  raise_to(s_peakDrive, a->drive);
+}
+
+SimEpisode sim_run_flip(FlipController& fc, float pitch0, float yaw0, int maxTicks,
+                        SimTickHook onTick, void* ctx) {
+  const bool verbose = g_sim_verbose;
+  auto* const prevHook = g_sim_motor_hook;
+  g_sim_verbose    = false;
+  g_sim_motor_hook = episode_motor_hook;
+  s_lastCmd   = motors_action_t{};
+  s_peakYaw = s_peakPitch = s_peakDrive = 0;
+
+  g_imu.pitch_deg      = pitch0;
+  g_imu.yaw_deg        = yaw0;
+  g_imu.pitch_rate_dps = 0.0f;
+  fc.triggerRecovery();
+
+  EpisodeLogWriter* const log = g_sim_episode_log;
+  if (log) log->beginEpisode(pitch0, yaw0, g_imu.roll_deg, g_imu.payload);
+
+  const int64_t nj0 = fc.powerBudget().energyNanoJ();
+  SimEpisode ep{};
+  for (ep.ticks = 1; ep.ticks <= maxTicks; ++ep.ticks) {
+    if (onTick) onTick(ep.ticks - 1, ctx);
+    fc.loop();
+    g_sim_now_ms += 10;
+    ep.jointPwmSum += std::abs(s_lastCmd.yaw) + std::abs(s_lastCmd.pitch);
+    ep.drivePwmSum += std::abs(s_lastCmd.drive);
+    if (log) {
+      EpisodeTick t{};
+      t.tick     = (uint32_t)ep.ticks;
+      t.pitchCd  = centideg(g_imu.pitch_deg);
+      t.yawCd    = centideg(g_imu.yaw_deg);
+      t.rollCd   = centideg(g_imu.roll_deg);
+      t.yawPwm   = s_lastCmd.yaw;
+      t.pitchPwm = s_lastCmd.pitch;
+      t.drivePwm = s_lastCmd.drive;
+      t.phase    = (uint8_t)fc.currentPhase();
+      t.flags    = fc.busy() ? FCOL_FLAG_BUSY : 0;
+      log->addTick(t);
+    }
+    if (!fc.busy()) { ep.completed = true; break; }
+  }
+  if (!ep.completed) ep.ticks = maxTicks;
+
+  // Leave the motors stopped so the next episode starts from rest; a flip
+  // that ran out of ticks scores as a failure. The params task would get
+  // the CPU now; any pending save happens here.
+  fc.abortRecovery(!ep.completed);
+  fc.serviceFlash();
+  ep.pitch = g_imu.pitch_deg;
+  ep.yaw   = g_imu.yaw_deg;
+  ep.peakYawPwm   = s_peakYaw;
+  ep.peakPitchPwm = s_peakPitch;
+  ep.peakDrivePwm = s_peakDrive;
+  ep.peakJointPwm = s_peakYaw > s_peakPitch ? s_peakYaw : s_peakPitch;
+  ep.energyJ = (float)(fc.powerBudget().energyNanoJ() - nj0) * 1e-9f;
+  if (log) log->endEpisode(ep.completed, ep.pitch, ep.yaw, (uint8_t)fc.lastStrategy());
+
+  g_sim_motor_hook = prevHook;
+  g_sim_verbose    = verbose;
+  return ep;
+}
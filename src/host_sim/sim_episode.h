@@ -0,0 +1,40 @@
+#pragma once
+// Headless flip episode runner shared by the host-sim tools.
+#include "mock_all.h"
+#include "../controllers/FlipController.h"
+#include "episode_log.h"
+
+struct SimEpisode {
+  int   ticks;      // controller ticks until the sequence finished
+  bool  completed;  // false if maxTicks ran out first
+  float pitch;      // final pose, deg
+  float yaw;
+  int   peakJointPwm;  // max |yaw| or |pitch| command seen
+  int   peakYawPwm;    // max |command| per motor
+  int   peakPitchPwm;
+  int   peakDrivePwm;
+  long  jointPwmSum;   // sum over ticks of |yaw| + |pitch|
+  long  drivePwmSum;   // sum over ticks of |drive|
+  float energyJ;       // battery energy drawn, from the controller's power budget
+};
+
+// When set, sim_run_flip() records every tick of every episode here.
+extern thread_local EpisodeLogWriter* g_sim_episode_log;
+
+// Per-thread setup for tools that step loop() themselves: no per-tick
+// logging, no spawned controller task, and motorHook (may be null) sees
+// every motor command outside sim_run_flip().
+void sim_headless_init(void (*motorHook)(const motors_action_t*) = nullptr);
+
+float sim_wrap_deg(float deg);
+
+// Called before every controller tick of an episode (tick counts from 0),
+// e.g. to disturb g_imu.
+typedef void (*SimTickHook)(int tick, void* ctx);
+
+// Places the robot at (pitch0, yaw0), triggers recovery and steps fc.loop()
+// at 10 ms per tick until the controller goes idle, then services a pending
+// parameter flash save as the params task would. No sleeping, no logging.
+// g_imu.payload is left as the caller set it.
+SimEpisode sim_run_flip(FlipController& fc, float pitch0, float yaw0, int maxTicks,
+                        SimTickHook onTick = nullptr, void* ctx = nullptr);
@@ -0,0 +1,209 @@
+// src/host_sim/video_pipeline.cpp
+#include "video_pipeline.h"
+
+#include <chrono>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+frame_data_t frames[4];
+
+void video_pin_thread(int cpu) {
+  if (cpu < 0) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// ------------------------------------------------------------- FramePool
+
+FramePool::FramePool(int count, size_t capacity)
+  : slab((size_t)count * capacity), bufs((size_t)count), lowWater(count) {
+  freeList.reserve((size_t)count);
+  for (int i = 0; i < count; ++i) {
+    Buffer& b  = bufs[(size_t)i];
+    b.data     = slab.data() + (size_t)i * capacity;
+    b.capacity = (uint32_t)capacity;
+    freeList.push_back(&b);
+  }
+}
+
+FramePool::Buffer* FramePool::acquire() {
+  std::lock_guard<std::mutex> g(m);
+  if (freeList.empty()) return nullptr;
+  Buffer* b = freeList.back();
+  freeList.pop_back();
+  if ((int)freeList.size() < lowWater) lowWater = (int)freeList.size();
+  b->refs.store(1, std::memory_order_relaxed);
+  return b;
+}
+
+void FramePool::release(Buffer* b) {
+  if (b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  std::lock_guard<std::mutex> g(m);
+  freeList.push_back(b);
+}
+
+int FramePool::freeCount() const {
+  std::lock_guard<std::mutex> g(m);
+  return (int)freeList.size();
+}
+
+int FramePool::minFree() const {
+  std::lock_guard<std::mutex> g(m);
+  return lowWater;
+}
+
+// ------------------------------------------------------------ FrameQueue
+
+bool FrameQueue::push(FramePool::Buffer* b) {
+  {
+    std::lock_guard<std::mutex> g(m);
+    if (closed || len == ring.size()) return false;
+    ring[(head + len++) % ring.size()] = b;
+  }
+  cv.notify_one();
+  return true;
+}
+
+FramePool::Buffer* FrameQueue::pop() {
+  std::unique_lock<std::mutex> lk(m);
+  cv.wait(lk, [this] { return len > 0 || closed; });
+  if (len == 0) return nullptr;
+  FramePool::Buffer* b = ring[head];
+  head = (head + 1) % ring.size();
+  --len;
+  return b;
+}
+
+void FrameQueue::close() {
+  { std::lock_guard<std::mutex> g(m); closed = true; }
+  cv.notify_all();
+}
+
+void FrameQueue::open() {
+  std::lock_guard<std::mutex> g(m);
+  closed = false;
+}
+
+// --------------------------------------------------------- VideoPipeline
+
+VideoPipeline::VideoPipeline(const VideoConfig& c)
+  : cfg(c),
+    framePool(c.poolFrames, (size_t)c.width * c.height * 3 / 2),
+    encodeQ(c.poolFrames),
+    uplinkQ(c.poolFrames) {
+  if (cfg.streams < 1) cfg.streams = 1;
+  if (cfg.streams > VIDEO_MAX_STREAMS) cfg.streams = VIDEO_MAX_STREAMS;
+}
+
+void VideoPipeline::start() {
+  if (running.exchange(true)) return;
+  usb_host_init();
+  encodeQ.open();
+  uplinkQ.open();
+  std::memset(frames, 0, sizeof(frames));
+  encoder  = std::thread([this] { video_pin_thread(cfg.cpu); encodeLoop(); });
+  uplink   = std::thread([this] { video_pin_thread(cfg.cpu); uplinkLoop(); });
+  producer = std::thread([this] { video_pin_thread(cfg.cpu); produceLoop(); });
+}
+
+void VideoPipeline::stop() {
+  if (!running.exchange(false)) return;
+  producer.join();
+  encodeQ.close();
+  uplinkQ.close();
+  encoder.join();
+  uplink.join();
+}
+
+VideoStats VideoPipeline::stats() const {
+  VideoStats s;
+  s.produced    = produced.load();
+  s.poolDrops   = poolDrops.load();
+  s.encoded     = encoded.load();
+  s.uplinked    = uplinked.load();
+  s.queueDrops  = queueDrops.load();
+  s.handoffs    = handoffs.load();
+  s.bytesFilled = bytesFilled.load();
+  s.checksum    = checksum.load();
+  return s;
+}
+
+void VideoPipeline::handOff(FrameQueue& q, FramePool::Buffer* b) {
+  framePool.retain(b);
+  if (q.push(b)) {
+    handoffs.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    framePool.release(b);
+    queueDrops.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Streams are captured round-robin, each at cfg.fps, phase-shifted so
+// their frames do not all land on the same instant.
+void VideoPipeline::produceLoop() {
+  using clk = std::chrono::steady_clock;
+  const auto period = std::chrono::duration_cast<clk::duration>(std::chrono::duration<double>(1.0 / cfg.fps));
+  const auto slot   = period / cfg.streams;
+  const uint32_t bytes = frameBytes();
+  const uint32_t yBytes = (uint32_t)cfg.width * cfg.height;
+
+  uint32_t seq[VIDEO_MAX_STREAMS] = {};
+  auto next = clk::now();
+  for (int s = 0; running.load(std::memory_order_relaxed); s = (s + 1) % cfg.streams) {
+    std::this_thread::sleep_until(next);
+    next += slot;
+
+    FramePool::Buffer* b = framePool.acquire();
+    if (!b) {
+      poolDrops.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    // Synthetic frame: a per-stream gradient that shifts every frame.
+    const uint8_t base = (uint8_t)(seq[s] * 3 + s * 64);
+    std::memset(b->data, base, yBytes);
+    std::memset(b->data + yBytes, 128, bytes - yBytes);
+    for (uint32_t row = 0; row < (uint32_t)cfg.height; row += 8) b->data[row * cfg.width] = (uint8_t)(base + row);
+    b->size   = bytes;
+    b->stream = (uint8_t)s;
+    b->seq    = seq[s]++;
+    bytesFilled.fetch_add(bytes, std::memory_order_relaxed);
+    produced.fetch_add(1, std::memory_order_relaxed);
+
+    frames[s].ready   = true;
+    frames[s].size[0] = (int)yBytes;
+    frames[s].size[1] = (int)(bytes - yBytes);
+
+    handOff(encodeQ, b);
+    handOff(uplinkQ, b);
+    framePool.release(b);  // producer's own reference
+  }
+}
+
+void VideoPipeline::encodeLoop() {
+  while (FramePool::Buffer* b = encodeQ.pop()) {
+    // Stand-in for the encoder: full passes over the frame in place.
+    uint32_t h = 2166136261u;
+    for (int pass = 0; pass < cfg.encodePasses; ++pass) {
+      const uint8_t* p = b->data;
+      for (uint32_t i = 0; i < b->size; i += 4) h = (h ^ p[i]) * 16777619u;
+    }
+    checksum.fetch_xor(h, std::memory_order_relaxed);
+    encoded.fetch_add(1, std::memory_order_relaxed);
+    framePool.release(b);
+  }
+}
+
+void VideoPipeline::uplinkLoop() {
+  while (FramePool::Buffer* b = uplinkQ.pop()) {
+    // Packetizer: reads the frame where it lies, one byte per stride.
+    uint32_t sum = b->seq;
+    const int stride = cfg.uplinkStride > 0 ? cfg.uplinkStride : 1;
+    for (uint32_t i = 0; i < b->size; i += (uint32_t)stride) sum += b->data[i];
+    checksum.fetch_xor(sum, std::memory_order_relaxed);
+    uplinked.fetch_add(1, std::memory_order_relaxed);
+    framePool.release(b);
+  }
+}
@@ -0,0 +1,129 @@
+#pragma once
+// Simulated camera path: USB host producer -> encoder + uplink consumers.
+//
+// Frames live in a fixed FramePool allocated once up front. The producer
+// fills a buffer in place (standing in for USB DMA), then hands the same
+// buffer to every consumer by reference count; nothing is copied after the
+// fill. The last consumer to release a buffer returns it to the pool. When
+// the pool is empty the producer drops the frame instead of blocking, like
+// a USB host with no free transfer buffer. A full consumer queue sheds that
+// consumer's reference the same way.
+//
+// frames[stream] (mock_all.h) mirrors the latest frame of each stream:
+// ready, and plane sizes (NV12: size[0] = Y, size[1] = UV).
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mock_all.h"
+
+static constexpr int VIDEO_MAX_STREAMS = 4;  // frames[4]
+
+class FramePool {
+public:
+  struct Buffer {
+    uint8_t*         data;
+    uint32_t         capacity;
+    uint32_t         size;
+    uint8_t          stream;
+    uint32_t         seq;
+    std::atomic<int> refs{0};
+  };
+
+  FramePool(int count, size_t capacity);
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  // nullptr when every buffer is in flight; otherwise refs == 1.
+  Buffer* acquire();
+  void retain(Buffer* b) { b->refs.fetch_add(1, std::memory_order_relaxed); }
+  void release(Buffer* b);
+
+  int count() const { return (int)bufs.size(); }
+  int freeCount() const;
+  int minFree() const;  // low-water mark since construction
+
+private:
+  std::vector<uint8_t>  slab;
+  std::vector<Buffer>   bufs;
+  std::vector<Buffer*>  freeList;
+  mutable std::mutex    m;
+  int                   lowWater;
+};
+
+// Bounded FIFO of buffer references for one consumer.
+class FrameQueue {
+public:
+  explicit FrameQueue(int capacity) : ring((size_t)capacity) {}
+  bool push(FramePool::Buffer* b);  // false when full
+  FramePool::Buffer* pop();         // blocks; nullptr once closed and drained
+  void close();
+  void open();                      // accepts pushes again after close()
+
+private:
+  std::vector<FramePool::Buffer*> ring;
+  size_t                  head = 0, len = 0;
+  bool                    closed = false;
+  std::mutex              m;
+  std::condition_variable cv;
+};
+
+struct VideoConfig {
+  int   streams       = 2;
+  int   width         = 1280;
+  int   height        = 720;
+  float fps           = 30.0f;
+  int   poolFrames    = 8;
+  int   encodePasses  = 2;   // encoder reads each frame this many times
+  int   uplinkStride  = 16;  // uplink touches every Nth byte (packetizer)
+  int   cpu           = -1;  // pin every pipeline thread here; -1 = no pinning
+};
+
+struct VideoStats {
+  uint64_t produced  = 0;
+  uint64_t poolDrops = 0;   // no free buffer at capture time
+  uint64_t encoded   = 0;
+  uint64_t uplinked  = 0;
+  uint64_t queueDrops = 0;  // a consumer queue was full
+  uint64_t handoffs  = 0;   // references passed to consumers
+  uint64_t bytesFilled = 0; // producer writes (the simulated DMA)
+  uint32_t checksum  = 0;   // encoder output, keeps the work observable
+};
+
+class VideoPipeline {
+public:
+  explicit VideoPipeline(const VideoConfig& cfg);
+  ~VideoPipeline() { stop(); }
+
+  // start() after stop() resumes with the same pool; counters keep adding up.
+  void start();
+  // Stops the producer, drains both consumers and joins every thread.
+  void stop();
+
+  VideoStats stats() const;
+  const FramePool& pool() const { return framePool; }
+
+private:
+  VideoConfig       cfg;
+  FramePool         framePool;
+  FrameQueue        encodeQ, uplinkQ;
+  std::atomic<bool> running{false};
+  std::thread       producer, encoder, uplink;
+
+  std::atomic<uint64_t> produced{0}, poolDrops{0}, encoded{0}, uplinked{0},
+                        queueDrops{0}, handoffs{0}, bytesFilled{0};
+  std::atomic<uint32_t> checksum{0};
+
+  uint32_t frameBytes() const { return (uint32_t)cfg.width * cfg.height * 3 / 2; }
+  void produceLoop();
+  void encodeLoop();
+  void uplinkLoop();
+  void handOff(FrameQueue& q, FramePool::Buffer* b);
+};
+
+// Pins the calling thread to cpu (no-op for cpu < 0).
+void video_pin_thread(int cpu);
@@ -0,0 +1,212 @@
+// src/host_sim/video_sim.cpp
+//
+// FlipController tick jitter with and without the simulated video path.
+// The flip task runs on its own thread at a real 10 ms period (sleep_until,
+// like vTaskDelayUntil) and keeps flipping from a rotating set of poses.
+// The camera pipeline (video_pipeline.h) is switched on and off in
+// alternating windows under the same flip task, so both conditions see the
+// same machine state. Ticks while the pipeline starts or stops (stop()
+// drains the consumers and joins their threads) count for neither
+// condition. By default every thread is pinned to CPU 0 to stand in
+// for the single-core target. Without --rt the flip task competes with the
+// pipeline as a normal thread and the tail is mostly host scheduler noise.
+// Reported per condition:
+//   wake lateness  = actual wake - scheduled tick, us
+//   loop time      = FlipController::loop() duration, us
+// --check also requires each condition to have run about its share of
+// 10 ms ticks, never to wake early, and to miss at most 1% of its ticks.
+//
+// Usage: ./video_sim [--seconds S] [--windows N] [--streams N] [--fps F]
+//                    [--size WxH] [--pool N] [--encode-passes K] [--cpu C]
+//                    [--rt] [--check]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "sim_episode.h"
+#include "video_pipeline.h"
+
+struct TickStats {
+  std::vector<int32_t> lateUs;
+  std::vector<int32_t> loopUs;
+  bool                 realtime = false;
+};
+
+static const float POSES[] = {180.0f, -90.0f, 90.0f, 150.0f};
+
+enum RunMode : int { RUN_IDLE = 0, RUN_VIDEO, RUN_SWITCH, RUN_DONE };
+
+// Runs until mode is RUN_DONE; each tick lands in out[mode at wake-up].
+static void flip_task(TickStats* out, const std::atomic<int>* mode, int ticks, int cpu, bool rt) {
+  using clk = std::chrono::steady_clock;
+  video_pin_thread(cpu);
+  if (rt) {
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    out[RUN_IDLE].realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) == 0;
+  }
+
+  sim_headless_init();
+
+  RSBL8512 yawMotor(0), pitchMotor(1);
+  FlipController fc(yawMotor, pitchMotor);
+  for (int m = RUN_IDLE; m <= RUN_SWITCH; ++m) {
+    out[m].lateUs.reserve((size_t)ticks);
+    out[m].loopUs.reserve((size_t)ticks);
+  }
+
+  int pose = 0;
+  auto next = clk::now();
+  for (;;) {
+    next += std::chrono::milliseconds(10);
+    std::this_thread::sleep_until(next);
+    const auto t0 = clk::now();
+    const int  m  = mode->load();
+    if (m == RUN_DONE) break;
+
+    if (!fc.busy()) {
+      g_imu.pitch_deg = POSES[pose++ % 4];
+      g_imu.yaw_deg   = 0.0f;
+      fc.triggerRecovery();
+    }
+    fc.loop();
+    g_sim_now_ms += 10;
+
+    const auto t1 = clk::now();
+    out[m].lateUs.push_back((int32_t)std::chrono::duration_cast<std::chrono::microseconds>(t0 - next).count());
+    out[m].loopUs.push_back((int32_t)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count());
+  }
+}
+
+static int32_t pct(std::vector<int32_t> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p / 100.0 * (double)(v.size() - 1) + 0.5);
+  return v[i];
+}
+
+static long count_over(const std::vector<int32_t>& v, int32_t us) {
+  return (long)std::count_if(v.begin(), v.end(), [us](int32_t x) { return x > us; });
+}
+
+static void print_ticks(const char* label, const TickStats& s) {
+  std::printf("  %-9s %6zu | %6d %6d %6d %7d | %7ld %6ld | %5d %5d %6d\n", label, s.lateUs.size(),
+              pct(s.lateUs, 50), pct(s.lateUs, 99), pct(s.lateUs, 99.9), pct(s.lateUs, 100),
+              count_over(s.lateUs, 1000), count_over(s.lateUs, 10000),
+              pct(s.loopUs, 50), pct(s.loopUs, 99), pct(s.loopUs, 100));
+}
+
+// Sanity of one condition's probe: within half of the expected tick count,
+// no early wake-ups, at most 1% of ticks a full period late.
+static bool check_ticks(const char* label, const TickStats& s, long expected) {
+  const long n      = (long)s.lateUs.size();
+  const long missed = count_over(s.lateUs, 10000);
+  const char* why = nullptr;
+  if (n < expected / 2 || n > expected * 3 / 2) why = "tick count far from expected";
+  else if (pct(s.lateUs, 0) < 0)                why = "woke before its tick";
+  else if (missed * 100 > n)                    why = "more than 1% of ticks missed";
+  if (why) std::printf("[VIDEO] %s: %ld ticks (expected ~%ld), %ld missed: %s\n", label, n, expected, missed, why);
+  return why == nullptr;
+}
+
+int main(int argc, char** argv) {
+  VideoConfig cfg;
+  cfg.cpu      = 0;
+  double secs    = 20.0;
+  int    windows = 20;
+  bool   rt      = false;
+  bool   check = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc)            secs = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--windows") && i + 1 < argc)       windows = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--streams") && i + 1 < argc)       cfg.streams = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--fps") && i + 1 < argc)           cfg.fps = (float)std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--size") && i + 1 < argc)          std::sscanf(argv[++i], "%dx%d", &cfg.width, &cfg.height);
+    else if (!std::strcmp(argv[i], "--pool") && i + 1 < argc)          cfg.poolFrames = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--encode-passes") && i + 1 < argc) cfg.encodePasses = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--cpu") && i + 1 < argc)           cfg.cpu = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--rt"))                            rt = true;
+    else if (!std::strcmp(argv[i], "--check"))                         check = true;
+    else {
+      std::fprintf(stderr, "usage: %s [--seconds S] [--windows N] [--streams N] [--fps F] [--size WxH] "
+                           "[--pool N] [--encode-passes K] [--cpu C] [--rt] [--check]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (cfg.streams < 1 || cfg.streams > VIDEO_MAX_STREAMS || cfg.fps <= 0.0f || cfg.poolFrames < 1 ||
+      cfg.width < 16 || cfg.height < 16 || secs <= 0.0 || windows < 2) {
+    std::fprintf(stderr, "bad video configuration\n");
+    return 2;
+  }
+  windows += windows & 1;  // as many windows with video as without
+  const auto window = std::chrono::microseconds((long long)(secs * 1e6 / windows));
+
+  std::printf("[VIDEO] %d stream(s) %dx%d NV12 @ %.1f fps, pool %d, encode passes %d, cpu %d%s\n",
+              cfg.streams, cfg.width, cfg.height, cfg.fps, cfg.poolFrames, cfg.encodePasses, cfg.cpu,
+              rt ? ", flip task SCHED_FIFO" : "");
+  std::printf("[VIDEO] %.1f s in %d alternating %.0f ms windows\n", secs, windows,
+              std::chrono::duration<double, std::milli>(window).count());
+  std::puts("  run        ticks | late us: p50    p99  p99.9     max | >1ms  >10ms | loop us: p50 p99 max");
+
+  TickStats        ticks[3];
+  std::atomic<int> mode{RUN_IDLE};
+  VideoPipeline    video(cfg);
+  std::thread flip(flip_task, ticks, &mode, (int)(secs * 50.0) + 1, cfg.cpu, rt);
+  for (int w = 0; w < windows; ++w) {
+    const bool on = w & 1;
+    if (on) {
+      mode = RUN_SWITCH;
+      video.start();
+      mode = RUN_VIDEO;
+    }
+    std::this_thread::sleep_for(window);
+    if (on) {
+      mode = RUN_SWITCH;
+      video.stop();
+      mode = RUN_IDLE;
+    }
+  }
+  mode = RUN_DONE;
+  flip.join();
+
+  if (rt && !ticks[RUN_IDLE].realtime) std::puts("  (SCHED_FIFO refused; flip task runs at normal priority)");
+  print_ticks("no video", ticks[RUN_IDLE]);
+  print_ticks("video", ticks[RUN_VIDEO]);
+  std::printf("  (%zu ticks during pipeline start/stop not counted)\n", ticks[RUN_SWITCH].lateUs.size());
+
+  const VideoStats vs = video.stats();
+  std::printf("[VIDEO] frames: produced %llu, encoded %llu, uplinked %llu, pool-empty drops %llu, "
+              "queue drops %llu\n",
+              (unsigned long long)vs.produced, (unsigned long long)vs.encoded, (unsigned long long)vs.uplinked,
+              (unsigned long long)vs.poolDrops, (unsigned long long)vs.queueDrops);
+  std::printf("[VIDEO] zero-copy: %llu hand-offs by reference, %.1f MB filled at capture, "
+              "pool low-water %d/%d free\n",
+              (unsigned long long)vs.handoffs, (double)vs.bytesFilled / 1e6, video.pool().minFree(),
+              video.pool().count());
+  for (int s = 0; s < cfg.streams; ++s) {
+    std::printf("[VIDEO] frames[%d]: ready=%d size={%d, %d}\n", s, (int)frames[s].ready,
+                frames[s].size[0], frames[s].size[1]);
+  }
+
+  if (!check) return 0;
+  // Every capture offers one reference per consumer, every accepted reference
+  // is consumed, and the pool is whole again once the pipeline has stopped.
+  bool ok = vs.handoffs + vs.queueDrops == 2 * vs.produced &&
+            vs.encoded + vs.uplinked == vs.handoffs &&
+            video.pool().freeCount() == video.pool().count() &&
+            vs.produced > 0;
+  // Half the run, in 10 ms ticks, per condition.
+  const long expected = (long)(secs * 50.0);
+  ok = check_ticks("no video", ticks[RUN_IDLE], expected) && ok;
+  ok = check_ticks("video", ticks[RUN_VIDEO], expected) && ok;
+  std::printf("[VIDEO] check: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}